@@ -0,0 +1,19 @@
+local luaBenchmark = TalkAction("/luabench")
+
+function luaBenchmark.onSay(player, words, param)
+	if not player:getGroup():getAccess() or player:getAccountType() < ACCOUNT_TYPE_GOD then
+		return true
+	end
+
+	local iterations = tonumber(param) or 100000
+	if not Game.benchmarkBindings(iterations) then
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Usage: /luabench [iterations]")
+		return false
+	end
+
+	player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua binding benchmark done, results written to the server log.")
+	return false
+end
+
+luaBenchmark:separator(" ")
+luaBenchmark:register()
@@ -0,0 +1,27 @@
+local luaProfiler = TalkAction("/luaprofile")
+
+function luaProfiler.onSay(player, words, param)
+	if not player:getGroup():getAccess() or player:getAccountType() < ACCOUNT_TYPE_GOD then
+		return true
+	end
+
+	if param == "start" then
+		Game.setLuaProfiler(true)
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua profiler started.")
+	elseif param == "stop" then
+		local fileName = Game.setLuaProfiler(false)
+		if fileName == nil then
+			player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua profiler is not running.")
+		elseif not fileName then
+			player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua profiler stopped, but the profile could not be written.")
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Lua profiler stopped, profile written to " .. fileName .. ".")
+		end
+	else
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Usage: /luaprofile start|stop")
+	end
+	return false
+end
+
+luaProfiler:separator(" ")
+luaProfiler:register()
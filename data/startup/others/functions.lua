@@ -156,15 +156,17 @@ function loadCustomMap()
 	local mapName = configManager.getString(configKeys.MAP_CUSTOM_NAME)
 	if configManager.getBoolean(configKeys.MAP_CUSTOM_ENABLED) then
 		Spdlog.info("Loading custom map")
-		Game.loadMap(configManager.getString(configKeys.MAP_CUSTOM_FILE))
-		Spdlog.info("Loaded " .. mapName .. " map")
-		-- It's load the spawn
-		-- 10 * 1000 = 10 seconds delay for load the spawn after loading the map
-		addEvent(
-		function()
+		-- The map is placed over the next dispatcher cycles, the spawn is loaded once all of its tiles exist
+		Game.loadMap(configManager.getString(configKeys.MAP_CUSTOM_FILE), function(loaded)
+			if not loaded then
+				Spdlog.warn("Failed to load " .. mapName .. " map, its spawn was not loaded")
+				return
+			end
+
+			Spdlog.info("Loaded " .. mapName .. " map")
 			Game.loadSpawnFile(configManager.getString(configKeys.MAP_CUSTOM_SPAWN))
 			Spdlog.info("Loaded " .. mapName .. " spawn")
-		end, 10 * 1000)
+		end)
 	end
 end
 
@@ -137,6 +137,7 @@ bool ConfigManager::load()
 		integer[GAME_PORT] = getGlobalNumber(L, "gameProtocolPort", 7172);
 		integer[LOGIN_PORT] = getGlobalNumber(L, "loginProtocolPort", 7171);
 		integer[STATUS_PORT] = getGlobalNumber(L, "statusProtocolPort", 7171);
+		integer[METRICS_PORT] = getGlobalNumber(L, "metricsPort", 0);
 
 		integer[MARKET_OFFER_DURATION] = getGlobalNumber(L, "marketOfferDuration", 30 * 24 * 60 * 60);
 
@@ -243,6 +244,8 @@ bool ConfigManager::load()
 	integer[MAX_ALLOWED_ON_A_DUMMY] = getGlobalNumber(L, "maxAllowedOnADummy", 1);
 	
 	integer[CRITICALCHANCE] = getGlobalNumber(L, "criticalChance", 10);
+	integer[MAP_LOAD_THREADS] = getGlobalNumber(L, "mapLoadThreads", 0);
+	integer[LUA_PRECOMPILE_THREADS] = getGlobalNumber(L, "luaPrecompileThreads", 0);
 
 	integer[PARTY_LIST_MAX_DISTANCE] = getGlobalNumber(L, "partyListMaxDistance", 0);
 
@@ -280,6 +283,7 @@ bool ConfigManager::load()
 
 	boolean[TASK_HUNTING_ENABLED] = getGlobalBoolean(L, "taskHuntingSystemEnabled", true);
 	boolean[TASK_HUNTING_FREE_THIRD_SLOT] = getGlobalBoolean(L, "taskHuntingFreeThirdSlot", false);
+	boolean[LUA_BYTECODE_CACHE] = getGlobalBoolean(L, "luaBytecodeCache", false);
 	integer[TASK_HUNTING_LIMIT_EXHAUST] = getGlobalNumber(L, "taskHuntingLimitedTasksExhaust", 72000);
 	integer[TASK_HUNTING_REROLL_PRICE_LEVEL] = getGlobalNumber(L, "taskHuntingRerollPricePerLevel", 200);
 	integer[TASK_HUNTING_SELECTION_LIST_PRICE] = getGlobalNumber(L, "taskHuntingSelectListPrice", 1);
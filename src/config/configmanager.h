@@ -73,6 +73,7 @@ class ConfigManager
 			PREY_FREE_THIRD_SLOT,
 			TASK_HUNTING_ENABLED,
 			TASK_HUNTING_FREE_THIRD_SLOT,
+			LUA_BYTECODE_CACHE,
 
 			LAST_BOOLEAN_CONFIG /* this must be the last one */
 		};
@@ -130,6 +131,7 @@ class ConfigManager
 			GAME_PORT,
 			LOGIN_PORT,
 			STATUS_PORT,
+			METRICS_PORT,
 			STAIRHOP_DELAY,
 			MAX_CONTAINER,
 			MAX_ITEM,
@@ -170,6 +172,8 @@ class ConfigManager
 			TASK_HUNTING_FREE_REROLL_TIME,
 			REWARD_BAG_DURATION,
 			CRITICALCHANCE,
+			MAP_LOAD_THREADS,
+			LUA_PRECOMPILE_THREADS,
 			LAST_INTEGER_CONFIG /* this must be the last one */
 		};
 
@@ -111,7 +111,7 @@ CombatDamage Combat::getCombatDamage(Creature* creature, Creature* target) const
 	return damage;
 }
 
-void Combat::getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, std::forward_list<Tile*>& list)
+void Combat::getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, CombatTileList& list)
 {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
 		return;
@@ -125,7 +125,7 @@ void Combat::getCombatArea(const Position& centerPos, const Position& targetPos,
 			tile = new StaticTile(targetPos.x, targetPos.y, targetPos.z);
 			g_game.map.setTile(targetPos, tile);
 		}
-		list.push_front(tile);
+		list.push_back(tile);
 	}
 }
 
@@ -816,7 +816,7 @@ void Combat::doCombat(Creature* caster, const Position& position) const
 
 void Combat::CombatFunc(Creature* caster, const Position& pos, const AreaCombat* area, const CombatParams& params, CombatFunction func, CombatDamage* data)
 {
-	std::forward_list<Tile*> tileList;
+	CombatTileList tileList;
 
 	if (caster) {
 		getCombatArea(caster->getPosition(), pos, area, tileList);
@@ -847,9 +847,15 @@ void Combat::CombatFunc(Creature* caster, const Position& pos, const AreaCombat*
 	const int32_t rangeY = maxY + Map::maxViewportY;
 	g_game.map.getSpectators(spectators, pos, true, true, rangeX, rangeX, rangeY, rangeY);
 
+	// tile permissions do not change while the combat runs, so resolve them once
+	boost::container::small_vector<bool, 64> tileAllowed;
+	tileAllowed.reserve(tileList.size());
+
 	int affected = 0;
 	for (Tile* tile : tileList) {
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
+		bool allowed = canDoCombat(caster, tile, params.aggressive) == RETURNVALUE_NOERROR;
+		tileAllowed.push_back(allowed);
+		if (!allowed) {
 			continue;
 		}
 
@@ -903,11 +909,13 @@ void Combat::CombatFunc(Creature* caster, const Position& pos, const AreaCombat*
 	}
 	
 	tmpDamage.affected = affected;
-	for (Tile* tile : tileList) {
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
+	for (size_t i = 0, size = tileList.size(); i < size; ++i) {
+		if (!tileAllowed[i]) {
 			continue;
 		}
 
+		Tile* tile = tileList[i];
+
 		if (CreatureVector* creatures = tile->getCreatures()) {
 			const Creature* topCreature = tile->getTopCreature();
 			for (Creature* creature : *creatures) {
@@ -1439,34 +1447,27 @@ AreaCombat::AreaCombat(const AreaCombat& rhs)
 	}
 }
 
-void AreaCombat::getList(const Position& centerPos, const Position& targetPos, std::forward_list<Tile*>& list) const
+void AreaCombat::getList(const Position& centerPos, const Position& targetPos, CombatTileList& list) const
 {
 	const MatrixArea* area = getArea(centerPos, targetPos);
 	if (!area) {
 		return;
 	}
 
-	uint32_t centerY, centerX;
-	area->getCenter(centerY, centerX);
-
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
-	uint32_t cols = area->getCols();
-	for (uint32_t y = 0, rows = area->getRows(); y < rows; ++y) {
-		for (uint32_t x = 0; x < cols; ++x) {
-			if (area->getValue(y, x) != 0) {
-				if (g_game.isSightClear(targetPos, tmpPos, true)) {
-					Tile* tile = g_game.map.getTile(tmpPos);
-					if (!tile) {
-						tile = new StaticTile(tmpPos.x, tmpPos.y, tmpPos.z);
-						g_game.map.setTile(tmpPos, tile);
-					}
-					list.push_front(tile);
-				}
-			}
-			tmpPos.x++;
+	const auto& offsets = area->getOffsets();
+	list.reserve(list.size() + offsets.size());
+	for (const auto& offset : offsets) {
+		Position tmpPos(targetPos.x + offset.first, targetPos.y + offset.second, targetPos.z);
+		if (!g_game.isSightClear(targetPos, tmpPos, true)) {
+			continue;
+		}
+
+		Tile* tile = g_game.map.getTile(tmpPos);
+		if (!tile) {
+			tile = new StaticTile(tmpPos.x, tmpPos.y, tmpPos.z);
+			g_game.map.setTile(tmpPos, tile);
 		}
-		tmpPos.x -= cols;
-		tmpPos.y++;
+		list.push_back(tile);
 	}
 }
 
@@ -1478,7 +1479,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 	if (op == MATRIXOPERATION_COPY) {
 		for (uint32_t y = 0; y < input->getRows(); ++y) {
 			for (uint32_t x = 0; x < input->getCols(); ++x) {
-				(*output)[y][x] = (*input)[y][x];
+				output->setValue(y, x, input->getValue(y, x));
 			}
 		}
 
@@ -1487,7 +1488,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 		for (uint32_t y = 0; y < input->getRows(); ++y) {
 			uint32_t rx = 0;
 			for (int32_t x = input->getCols(); --x >= 0;) {
-				(*output)[y][rx++] = (*input)[y][x];
+				output->setValue(y, rx++, input->getValue(y, x));
 			}
 		}
 
@@ -1496,7 +1497,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 		for (uint32_t x = 0; x < input->getCols(); ++x) {
 			uint32_t ry = 0;
 			for (int32_t y = input->getRows(); --y >= 0;) {
-				(*output)[ry++][x] = (*input)[y][x];
+				output->setValue(ry++, x, input->getValue(y, x));
 			}
 		}
 
@@ -1544,7 +1545,7 @@ void AreaCombat::copyArea(const MatrixArea* input, MatrixArea* output, MatrixOpe
 				int32_t rotatedY = static_cast<int32_t>(round(newX * c + newY * d));
 
 				//write in the output matrix using rotated coordinates
-				(*output)[rotatedY + rotateCenterY][rotatedX + rotateCenterX] = (*input)[y][x];
+				output->setValue(rotatedY + rotateCenterY, rotatedX + rotateCenterX, input->getValue(y, x));
 			}
 		}
 
@@ -1608,6 +1609,8 @@ void AreaCombat::setupArea(const std::list<uint32_t>& list, uint32_t rows)
 	MatrixArea* westArea = new MatrixArea(maxOutput, maxOutput);
 	copyArea(area, westArea, MATRIXOPERATION_ROTATE270);
 	areas[DIRECTION_WEST] = westArea;
+
+	compileAreas();
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread)
@@ -1708,6 +1711,15 @@ void AreaCombat::setupExtArea(const std::list<uint32_t>& list, uint32_t rows)
 	MatrixArea* seArea = new MatrixArea(maxOutput, maxOutput);
 	copyArea(swArea, seArea, MATRIXOPERATION_MIRROR);
 	areas[DIRECTION_SOUTHEAST] = seArea;
+
+	compileAreas();
+}
+
+void AreaCombat::compileAreas()
+{
+	for (const auto& it : areas) {
+		it.second->compile();
+	}
 }
 
 //**********************************************************//
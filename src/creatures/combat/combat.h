@@ -20,6 +20,8 @@
 #ifndef FS_COMBAT_H_B02CE79230FC43708699EE91FCC8F7CC
 #define FS_COMBAT_H_B02CE79230FC43708699EE91FCC8F7CC
 
+#include <boost/container/small_vector.hpp>
+
 #include "items/thing.h"
 #include "creatures/combat/condition.h"
 #include "map/map.h"
@@ -92,51 +94,18 @@ using CombatFunction = std::function<void(Creature*, Creature*, const CombatPara
 class MatrixArea
 {
 	public:
-		MatrixArea(uint32_t initRows, uint32_t initCols): centerX(0), centerY(0), rows(initRows), cols(initCols) {
-			data_ = new bool*[rows];
-
-			for (uint32_t row = 0; row < rows; ++row) {
-				data_[row] = new bool[cols];
-
-				for (uint32_t col = 0; col < cols; ++col) {
-					data_[row][col] = 0;
-				}
-			}
-		}
-
-		MatrixArea(const MatrixArea& rhs) {
-			centerX = rhs.centerX;
-			centerY = rhs.centerY;
-			rows = rhs.rows;
-			cols = rhs.cols;
-
-			data_ = new bool*[rows];
+		MatrixArea(uint32_t initRows, uint32_t initCols): centerX(0), centerY(0), rows(initRows), cols(initCols), data_(initRows * initCols, false) {}
 
-			for (uint32_t row = 0; row < rows; ++row) {
-				data_[row] = new bool[cols];
-
-				for (uint32_t col = 0; col < cols; ++col) {
-					data_[row][col] = rhs.data_[row][col];
-				}
-			}
-		}
-
-		~MatrixArea() {
-			for (uint32_t row = 0; row < rows; ++row) {
-				delete[] data_[row];
-			}
-
-			delete[] data_;
-		}
+		MatrixArea(const MatrixArea& rhs) = default;
 
 		// non-assignable
 		MatrixArea& operator=(const MatrixArea&) = delete;
 
-		void setValue(uint32_t row, uint32_t col, bool value) const {
-			data_[row][col] = value;
+		void setValue(uint32_t row, uint32_t col, bool value) {
+			data_[row * cols + col] = value;
 		}
 		bool getValue(uint32_t row, uint32_t col) const {
-			return data_[row][col];
+			return data_[row * cols + col];
 		}
 
 		void setCenter(uint32_t y, uint32_t x) {
@@ -155,11 +124,23 @@ class MatrixArea
 			return cols;
 		}
 
-		const bool* operator[](uint32_t i) const {
-			return data_[i];
+		/**
+		 * Builds the list of set cells as offsets from the center, so a cast
+		 * only visits the affected positions instead of the whole matrix.
+		 * Must be called again after the matrix or its center change.
+		 */
+		void compile() {
+			offsets.clear();
+			for (uint32_t y = 0; y < rows; ++y) {
+				for (uint32_t x = 0; x < cols; ++x) {
+					if (getValue(y, x)) {
+						offsets.emplace_back(static_cast<int32_t>(x) - static_cast<int32_t>(centerX), static_cast<int32_t>(y) - static_cast<int32_t>(centerY));
+					}
+				}
+			}
 		}
-		bool* operator[](uint32_t i) {
-			return data_[i];
+		const std::vector<std::pair<int32_t, int32_t>>& getOffsets() const {
+			return offsets;
 		}
 
 	private:
@@ -168,9 +149,14 @@ class MatrixArea
 
 		uint32_t rows;
 		uint32_t cols;
-		bool** data_;
+		// packed row-major bits
+		std::vector<bool> data_;
+		std::vector<std::pair<int32_t, int32_t>> offsets;
 };
 
+// most areas (great fireball, ultimate explosion) fit without touching the heap
+using CombatTileList = boost::container::small_vector<Tile*, 64>;
+
 class AreaCombat
 {
 	public:
@@ -184,7 +170,7 @@ class AreaCombat
 		// non-assignable
 		AreaCombat& operator=(const AreaCombat&) = delete;
 
-		void getList(const Position& centerPos, const Position& targetPos, std::forward_list<Tile*>& list) const;
+		void getList(const Position& centerPos, const Position& targetPos, CombatTileList& list) const;
 
 		void setupArea(const std::list<uint32_t>& list, uint32_t rows);
 		void setupArea(int32_t length, int32_t spread);
@@ -204,6 +190,7 @@ class AreaCombat
 
 		MatrixArea* createArea(const std::list<uint32_t>& list, uint32_t rows);
 		void copyArea(const MatrixArea* input, MatrixArea* output, MatrixOperation_t op) const;
+		void compileAreas();
 
 		MatrixArea* getArea(const Position& centerPos, const Position& targetPos) const {
 			int32_t dx = Position::getOffsetX(targetPos, centerPos);
@@ -264,7 +251,7 @@ class Combat
 		static void doCombatDispel(Creature* caster, Creature* target, const CombatParams& params);
 		static void doCombatDispel(Creature* caster, const Position& position, const AreaCombat* area, const CombatParams& params);
 
-		static void getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, std::forward_list<Tile*>& list);
+		static void getCombatArea(const Position& centerPos, const Position& targetPos, const AreaCombat* area, CombatTileList& list);
 
 		static bool isInPvpZone(const Creature* attacker, const Creature* target);
 		static bool isProtected(const Player* attacker, const Player* target);
@@ -33,6 +33,7 @@ double Creature::speedC = -4795.01;
 extern Game g_game;
 extern ConfigManager g_config;
 extern CreatureEvents* g_creatureEvents;
+extern LuaEnvironment g_luaEnvironment;
 
 Creature::Creature()
 {
@@ -50,6 +51,12 @@ Creature::~Creature()
 		condition->endCondition(this);
 		delete condition;
 	}
+
+	// a later object at this address must not reuse the userdata and its metatable
+	lua_State* L = luaUserdata ? g_luaEnvironment.getLuaState() : nullptr;
+	if (L) {
+		LuaScriptInterface::removeCachedUserdata(L, this);
+	}
 }
 
 bool Creature::canSee(const Position& myPos, const Position& pos, int32_t viewRangeX, int32_t viewRangeY)
@@ -322,24 +329,30 @@ void Creature::stopEventWalk()
 
 void Creature::updateMapCache()
 {
-	Tile* newTile;
 	const Position& myPos = getPosition();
-	Position pos(0, 0, myPos.z);
-
-	for (int32_t y = -maxWalkCacheHeight; y <= maxWalkCacheHeight; ++y) {
-		for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
-			pos.x = myPos.getX() + x;
-			pos.y = myPos.getY() + y;
-			newTile = g_game.map.getTile(pos);
-			updateTileCache(newTile, pos);
+	for (int32_t y = 0; y < mapWalkHeight; ++y) {
+		// rows are assembled locally and stored once
+		MapWalkRow row = 0;
+		for (int32_t x = 0; x < mapWalkWidth; ++x) {
+			const Tile* tile = g_game.map.getTile(myPos.getX() - maxWalkCacheWidth + x, myPos.getY() - maxWalkCacheHeight + y, myPos.z);
+			if (tile && tile->queryAdd(0, *this, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR) {
+				row |= static_cast<MapWalkRow>(1) << x;
+			}
 		}
+		localMapCache[y] = row;
 	}
 }
 
 void Creature::updateTileCache(const Tile* newTile, int32_t dx, int32_t dy)
 {
 	if (std::abs(dx) <= maxWalkCacheWidth && std::abs(dy) <= maxWalkCacheHeight) {
-		localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx] = newTile && newTile->queryAdd(0, *this, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR;
+		MapWalkRow& row = localMapCache[maxWalkCacheHeight + dy];
+		const MapWalkRow bit = static_cast<MapWalkRow>(1) << (maxWalkCacheWidth + dx);
+		if (newTile && newTile->queryAdd(0, *this, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) == RETURNVALUE_NOERROR) {
+			row |= bit;
+		} else {
+			row &= ~bit;
+		}
 	}
 }
 
@@ -372,7 +385,7 @@ int32_t Creature::getWalkCache(const Position& pos) const
 	if (std::abs(dx) <= maxWalkCacheWidth) {
 		int32_t dy = Position::getOffsetY(pos, myPos);
 		if (std::abs(dy) <= maxWalkCacheHeight) {
-			if (localMapCache[maxWalkCacheHeight + dy][maxWalkCacheWidth + dx]) {
+			if (localMapCache[maxWalkCacheHeight + dy] & (static_cast<MapWalkRow>(1) << (maxWalkCacheWidth + dx))) {
 				return 1;
 			} else {
 				return 0;
@@ -526,9 +539,7 @@ void Creature::onCreatureMove(Creature* creature, const Tile* newTile, const Pos
 
 				if (oldPos.y > newPos.y) { //north
 					//shift y south
-					for (int32_t y = mapWalkHeight - 1; --y >= 0;) {
-						memcpy(localMapCache[y + 1], localMapCache[y], sizeof(localMapCache[y]));
-					}
+					memmove(localMapCache + 1, localMapCache, sizeof(localMapCache[0]) * (mapWalkHeight - 1));
 
 					//update 0
 					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
@@ -537,9 +548,7 @@ void Creature::onCreatureMove(Creature* creature, const Tile* newTile, const Pos
 					}
 				} else if (oldPos.y < newPos.y) { // south
 					//shift y north
-					for (int32_t y = 0; y <= mapWalkHeight - 2; ++y) {
-						memcpy(localMapCache[y], localMapCache[y + 1], sizeof(localMapCache[y]));
-					}
+					memmove(localMapCache, localMapCache + 1, sizeof(localMapCache[0]) * (mapWalkHeight - 1));
 
 					//update mapWalkHeight - 1
 					for (int32_t x = -maxWalkCacheWidth; x <= maxWalkCacheWidth; ++x) {
@@ -561,9 +570,7 @@ void Creature::onCreatureMove(Creature* creature, const Tile* newTile, const Pos
 					}
 
 					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = 0; x <= mapWalkWidth - 2; ++x) {
-							localMapCache[y][x] = localMapCache[y][x + 1];
-						}
+						localMapCache[y] >>= 1;
 					}
 
 					//update mapWalkWidth - 1
@@ -584,9 +591,7 @@ void Creature::onCreatureMove(Creature* creature, const Tile* newTile, const Pos
 					}
 
 					for (int32_t y = starty; y <= endy; ++y) {
-						for (int32_t x = mapWalkWidth - 1; --x >= 0;) {
-							localMapCache[y][x + 1] = localMapCache[y][x];
-						}
+						localMapCache[y] = (localMapCache[y] << 1) & mapWalkRowMask;
 					}
 
 					//update 0
@@ -526,6 +526,11 @@ class Creature : virtual public Thing
 			}
 		}
 
+		// set when a script is handed this creature, see LuaScriptInterface::pushCachedUserdata
+		void setLuaUserdata() {
+			luaUserdata = true;
+		}
+
 		bool isInfluenced() const {
 			return influenced;
 		}
@@ -551,6 +556,11 @@ class Creature : virtual public Thing
 		static constexpr int32_t maxWalkCacheWidth = (mapWalkWidth - 1) / 2;
 		static constexpr int32_t maxWalkCacheHeight = (mapWalkHeight - 1) / 2;
 
+		// each row of the walk cache is a bitmask, bit x set when the tile is walkable
+		using MapWalkRow = uint32_t;
+		static_assert(mapWalkWidth <= 32, "walk cache row does not fit MapWalkRow");
+		static constexpr MapWalkRow mapWalkRowMask = (static_cast<MapWalkRow>(1) << mapWalkWidth) - 1;
+
 		Position position;
 
 		using CountMap = std::map<uint32_t, CountBlock_t>;
@@ -576,6 +586,7 @@ class Creature : virtual public Thing
 		 * @see Monster::death()
 		 */
 		bool summoned = false;
+		bool luaUserdata = false;
 
 		uint64_t lastStep = 0;
 		uint32_t referenceCounter = 0;
@@ -610,7 +621,7 @@ class Creature : virtual public Thing
 
 		time_t fiendRemoveTime = 0;
 
-		bool localMapCache[mapWalkHeight][mapWalkWidth] = {{ false }};
+		MapWalkRow localMapCache[mapWalkHeight] = {};
 		bool isInternalRemoved = false;
 		bool isMapLoaded = false;
 		bool isUpdatingPath = false;
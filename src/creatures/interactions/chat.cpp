@@ -150,12 +150,34 @@ bool ChatChannel::talk(const Player& fromPlayer, SpeakClasses type, const std::s
 		return false;
 	}
 
+	if (!fromPlayer.hasFlag(PlayerFlag_CannotBeMuted) && !takeDeliveries(users.size())) {
+		fromPlayer.sendCancelMessage("This channel is too busy right now, try again in a moment.");
+		return false;
+	}
+
+	NetworkMessage msg;
+	ProtocolGame::addChannelMessage(msg, &fromPlayer, type, text, id);
 	for (const auto& it : users) {
-		it.second->sendToChannel(&fromPlayer, type, text, id);
+		it.second->sendNetworkMessage(msg);
 	}
 	return true;
 }
 
+bool ChatChannel::takeDeliveries(int64_t deliveries)
+{
+	int64_t now = OTSYS_TIME();
+	deliveryTokens = std::min<int64_t>(DELIVERIES_BURST, deliveryTokens + (now - lastRefill) * DELIVERIES_PER_SECOND / 1000);
+	lastRefill = now;
+
+	// a message bigger than the whole burst still goes through on a full bucket
+	if (deliveryTokens < std::min(deliveries, DELIVERIES_BURST)) {
+		return false;
+	}
+
+	deliveryTokens -= deliveries;
+	return true;
+}
+
 bool ChatChannel::executeCanJoinEvent(const Player& player)
 {
 	if (canJoinEvent == -1) {
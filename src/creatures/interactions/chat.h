@@ -83,6 +83,17 @@ class ChatChannel
 		uint16_t id;
 		bool publicChannel = false;
 
+	private:
+		// Token bucket of message deliveries, a message to the channel costs
+		// one token per listener so crowded channels accept fewer messages
+		static constexpr int64_t DELIVERIES_PER_SECOND = 20000;
+		static constexpr int64_t DELIVERIES_BURST = 2 * DELIVERIES_PER_SECOND;
+
+		bool takeDeliveries(int64_t deliveries);
+
+		int64_t deliveryTokens = DELIVERIES_BURST;
+		int64_t lastRefill = 0;
+
 	friend class Chat;
 };
 
@@ -38,8 +38,6 @@ extern IOBestiary g_bestiary;
 int32_t Monster::despawnRange;
 int32_t Monster::despawnRadius;
 
-uint32_t Monster::monsterAutoID = 0x40000000;
-
 Monster* Monster::createMonster(const std::string& name)
 {
 	MonsterType* mType = g_monsters.getMonsterType(name);
@@ -82,7 +80,7 @@ Monster::~Monster()
 
 void Monster::addList()
 {
-	g_game.addMonster(this);
+	id = g_game.addMonster(this);
 }
 
 void Monster::removeList()
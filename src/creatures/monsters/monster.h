@@ -52,11 +52,8 @@ class Monster final : public Creature
 			return this;
 		}
 
-		void setID() override {
-			if (id == 0) {
-				id = monsterAutoID++; 
-			}
-		}
+		// the id is handed out by Game::addMonster when the monster is added
+		void setID() override {}
 
 		void removeList() override;
 		void addList() override;
@@ -223,8 +220,6 @@ class Monster final : public Creature
 
 		bool becomeStronger(bool fiendishMonster = false);
 
-		static uint32_t monsterAutoID;
-
 	private:
 		CreatureHashSet friendList;
 		CreatureList targetList;
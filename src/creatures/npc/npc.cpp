@@ -26,21 +26,20 @@
 extern Game g_game;
 extern LuaEnvironment g_luaEnvironment;
 
-uint32_t Npc::npcAutoID = 0x80000000;
 NpcScriptInterface* Npc::scriptInterface = nullptr;
 
 void Npcs::reload()
 {
-	const std::map<uint32_t, Npc*>& npcs = g_game.getNpcs();
-	for (const auto& it : npcs) {
-		it.second->closeAllShopWindows();
+	const CreatureSlotMap<Npc>& npcs = g_game.getNpcs();
+	for (Npc* npc : npcs) {
+		npc->closeAllShopWindows();
 	}
 
 	delete Npc::scriptInterface;
 	Npc::scriptInterface = nullptr;
 
-	for (const auto& it : npcs) {
-		it.second->reload();
+	for (Npc* npc : npcs) {
+		npc->reload();
 	}
 }
 
@@ -70,7 +69,7 @@ Npc::~Npc()
 
 void Npc::addList()
 {
-	g_game.addNpc(this);
+	id = g_game.addNpc(this);
 }
 
 void Npc::removeList()
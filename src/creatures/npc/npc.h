@@ -121,11 +121,8 @@ class Npc final : public Creature
 			return pushable && walkTicks != 0;
 		}
 
-		void setID() override {
-			if (id == 0) {
-				id = npcAutoID++;
-			}
-		}
+		// the id is handed out by Game::addNpc when the npc is added
+		void setID() override {}
 
 		void removeList() override;
 		void addList() override;
@@ -193,8 +190,6 @@ class Npc final : public Creature
 
 		NpcScriptInterface* getScriptInterface();
 
-		static uint32_t npcAutoID;
-
 	private:
 		explicit Npc(const std::string& name);
 
@@ -73,6 +73,7 @@ void Party::disband()
 		currentLeader->sendCreatureSkull(member);
 	}
 	memberList.clear();
+	g_game.removePartyStatusUpdate(this);
 	delete this;
 }
 
@@ -400,20 +401,27 @@ void Party::shareExperience(uint64_t experience, Creature* source/* = nullptr*/)
 	leader->onGainSharedExperience(shareExperience, source);
 }
 
-bool Party::canUseSharedExperience(const Player* player) const
+uint32_t Party::getSharedExperienceMinLevel() const
 {
-	if (memberList.empty()) {
-		return false;
-	}
-
 	uint32_t highestLevel = leader->getLevel();
 	for (Player* member : memberList) {
 		if (member->getLevel() > highestLevel) {
 			highestLevel = member->getLevel();
 		}
 	}
+	return static_cast<uint32_t>(std::ceil((static_cast<float>(highestLevel) * 2) / 3));
+}
+
+bool Party::canUseSharedExperience(const Player* player) const
+{
+	if (memberList.empty()) {
+		return false;
+	}
+	return canUseSharedExperience(player, getSharedExperienceMinLevel());
+}
 
-	uint32_t minLevel = static_cast<uint32_t>(std::ceil((static_cast<float>(highestLevel) * 2) / 3));
+bool Party::canUseSharedExperience(const Player* player, uint32_t minLevel) const
+{
 	if (player->getLevel() < minLevel) {
 		return false;
 	}
@@ -439,12 +447,18 @@ bool Party::canUseSharedExperience(const Player* player) const
 
 bool Party::canEnableSharedExperience()
 {
-	if (!canUseSharedExperience(leader)) {
+	if (memberList.empty()) {
+		return false;
+	}
+
+	// the level range is the same for everyone, no need to find it per member
+	uint32_t minLevel = getSharedExperienceMinLevel();
+	if (!canUseSharedExperience(leader, minLevel)) {
 		return false;
 	}
 
 	for (Player* member : memberList) {
-		if (!canUseSharedExperience(member)) {
+		if (!canUseSharedExperience(member, minLevel)) {
 			return false;
 		}
 	}
@@ -548,32 +562,63 @@ void Party::updatePlayerStatus(Player* player, const Position& oldPos, const Pos
 
 void Party::updatePlayerHealth(const Player* player, const Creature* target, uint8_t healthPercent)
 {
-	int32_t maxDistance = g_config.getNumber(ConfigManager::PARTY_LIST_MAX_DISTANCE);
-	for (Player* member : memberList) {
-		bool condition = (maxDistance == 0 || (Position::getDistanceX(player->getPosition(), member->getPosition()) <= maxDistance && Position::getDistanceY(player->getPosition(), member->getPosition()) <= maxDistance));
-		if (condition) {
-			member->sendPartyCreatureHealth(target, healthPercent);
-		}
-	}
-	bool condition = (maxDistance == 0 || (Position::getDistanceX(player->getPosition(), leader->getPosition()) <= maxDistance && Position::getDistanceY(player->getPosition(), leader->getPosition()) <= maxDistance));
-	if (condition) {
-		leader->sendPartyCreatureHealth(target, healthPercent);
-	}
+	addStatusUpdate();
+	pendingHealth[target->getID()] = {player->getID(), healthPercent};
 }
 
 void Party::updatePlayerMana(const Player* player, uint8_t manaPercent)
+{
+	addStatusUpdate();
+	pendingMana[player->getID()] = manaPercent;
+}
+
+void Party::addStatusUpdate()
+{
+	if (pendingHealth.empty() && pendingMana.empty()) {
+		g_game.addPartyStatusUpdate(this);
+	}
+}
+
+void Party::sendStatusUpdates()
 {
 	int32_t maxDistance = g_config.getNumber(ConfigManager::PARTY_LIST_MAX_DISTANCE);
-	for (Player* member : memberList) {
-		bool condition = (maxDistance == 0 || (Position::getDistanceX(player->getPosition(), member->getPosition()) <= maxDistance && Position::getDistanceY(player->getPosition(), member->getPosition()) <= maxDistance));
-		if (condition) {
-			member->sendPartyPlayerMana(player, manaPercent);
+	for (const auto& it : pendingHealth) {
+		const Creature* target = g_game.getCreatureByID(it.first);
+		const Player* player = g_game.getPlayerByID(it.second.playerId);
+		if (!target || !player || player->getParty() != this) {
+			continue;
+		}
+
+		const Position& playerPos = player->getPosition();
+		for (Player* member : memberList) {
+			if (isInStatusRange(playerPos, member->getPosition(), maxDistance)) {
+				member->sendPartyCreatureHealth(target, it.second.healthPercent);
+			}
+		}
+		if (isInStatusRange(playerPos, leader->getPosition(), maxDistance)) {
+			leader->sendPartyCreatureHealth(target, it.second.healthPercent);
 		}
 	}
-	bool condition = (maxDistance == 0 || (Position::getDistanceX(player->getPosition(), leader->getPosition()) <= maxDistance && Position::getDistanceY(player->getPosition(), leader->getPosition()) <= maxDistance));
-	if (condition) {
-		leader->sendPartyPlayerMana(player, manaPercent);
+
+	for (const auto& it : pendingMana) {
+		const Player* player = g_game.getPlayerByID(it.first);
+		if (!player || player->getParty() != this) {
+			continue;
+		}
+
+		const Position& playerPos = player->getPosition();
+		for (Player* member : memberList) {
+			if (isInStatusRange(playerPos, member->getPosition(), maxDistance)) {
+				member->sendPartyPlayerMana(player, it.second);
+			}
+		}
+		if (isInStatusRange(playerPos, leader->getPosition(), maxDistance)) {
+			leader->sendPartyPlayerMana(player, it.second);
+		}
 	}
+
+	pendingHealth.clear();
+	pendingMana.clear();
 }
 
 void Party::updatePlayerVocation(const Player* player)
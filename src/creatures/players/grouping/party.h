@@ -127,10 +127,30 @@ class Party
 		void updatePlayerHealth(const Player* player, const Creature* target, uint8_t healthPercent);
 		void updatePlayerMana(const Player* player, uint8_t manaPercent);
 		void updatePlayerVocation(const Player* player);
+		// Health and mana changes are gathered and sent once per creature check
+		void sendStatusUpdates();
 
 		bool hasInformation = false;
 
 	private:
+		struct PendingHealth {
+			uint32_t playerId;
+			uint8_t healthPercent;
+		};
+
+		static bool isInStatusRange(const Position& pos, const Position& otherPos, int32_t maxDistance) {
+			return maxDistance == 0 || (Position::getDistanceX(pos, otherPos) <= maxDistance && Position::getDistanceY(pos, otherPos) <= maxDistance);
+		}
+
+		uint32_t getSharedExperienceMinLevel() const;
+		bool canUseSharedExperience(const Player* player, uint32_t minLevel) const;
+		void addStatusUpdate();
+
+		// by creature id, the player is the member the creature belongs to
+		std::map<uint32_t, PendingHealth> pendingHealth;
+		// by player id
+		std::map<uint32_t, uint8_t> pendingMana;
+
 		std::map<uint32_t, int64_t> ticksMap;
 		ActiveVector activeList;
 
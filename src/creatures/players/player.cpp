@@ -29,6 +29,7 @@
 #include "lua/creature/creatureevent.h"
 #include "lua/creature/events.h"
 #include "game/game.h"
+#include "game/cyclopediacache.h"
 #include "io/iologindata.h"
 #include "creatures/monsters/monster.h"
 #include "creatures/monsters/monsters.h"
@@ -2461,6 +2462,7 @@ void Player::resetSpellsCooldown()
 void Player::death(Creature* lastHitCreature)
 {
 	loginPosition = town->getTemplePosition();
+	CyclopediaCache::getInstance().invalidate(guid);
 
 	g_game.sendSingleSoundEffect(this->getPosition(), sex == PLAYERSEX_FEMALE ? SOUND_EFFECT_TYPE_HUMAN_FEMALE_DEATH : SOUND_EFFECT_TYPE_HUMAN_MALE_DEATH, this);
 
@@ -3322,6 +3324,7 @@ void Player::addThing(int32_t index, Thing* thing)
 
 	item->setParent(this);
 	inventory[index] = item;
+	invalidateItemTypeCountIndex();
 
 	//send to client
 	sendInventoryItem(static_cast<slots_t>(index), item);
@@ -3341,6 +3344,7 @@ void Player::updateThing(Thing* thing, uint16_t itemId, uint32_t count)
 
 	item->setID(itemId);
 	item->setSubType(count);
+	invalidateItemTypeCountIndex();
 
 	//send to client
 	sendInventoryItem(static_cast<slots_t>(index), item);
@@ -3374,6 +3378,7 @@ void Player::replaceThing(uint32_t index, Thing* thing)
 	item->setParent(this);
 
 	inventory[index] = item;
+	invalidateItemTypeCountIndex();
 }
 
 void Player::removeThing(Thing* thing, uint32_t count)
@@ -3388,6 +3393,8 @@ void Player::removeThing(Thing* thing, uint32_t count)
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	invalidateItemTypeCountIndex();
+
 	if (item->isStackable()) {
 		if (count == item->getItemCount()) {
 			//send change to client
@@ -3440,8 +3447,37 @@ size_t Player::getLastIndex() const
 	return CONST_SLOT_LAST + 1;
 }
 
+void Player::rebuildItemTypeCountIndex() const
+{
+	itemTypeCountIndex.clear();
+	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
+		Item* item = inventory[i];
+		if (!item) {
+			continue;
+		}
+
+		itemTypeCountIndex[item->getID()] += Item::countByType(item, -1);
+
+		if (Container* container = item->getContainer()) {
+			for (ContainerIterator it = container->iterator(); it.hasNext(); it.advance()) {
+				itemTypeCountIndex[(*it)->getID()] += Item::countByType(*it, -1);
+			}
+		}
+	}
+	itemTypeCountIndexDirty = false;
+}
+
 uint32_t Player::getItemTypeCount(uint16_t itemId, int32_t subType /*= -1*/) const
 {
+	if (subType == -1) {
+		if (itemTypeCountIndexDirty) {
+			rebuildItemTypeCountIndex();
+		}
+
+		auto it = itemTypeCountIndex.find(itemId);
+		return it != itemTypeCountIndex.end() ? it->second : 0;
+	}
+
 	uint32_t count = 0;
 	for (int32_t i = CONST_SLOT_FIRST; i <= CONST_SLOT_LAST; i++) {
 		Item* item = inventory[i];
@@ -3726,6 +3762,8 @@ Thing* Player::getThing(size_t index) const
 
 void Player::postAddNotification(Thing* thing, const Cylinder* oldParent, int32_t index, cylinderlink_t link /*= LINK_OWNER*/)
 {
+	invalidateItemTypeCountIndex();
+
 	if (link == LINK_OWNER) {
 		//calling movement scripts
 		g_moveEvents->onPlayerEquip(this, thing->getItem(), static_cast<slots_t>(index), false);
@@ -3748,8 +3786,7 @@ void Player::postAddNotification(Thing* thing, const Cylinder* oldParent, int32_
 
 		updateInventoryWeight();
 		updateItemsLight();
-		sendInvetoryItems();
-		sendStats();
+		scheduleInventoryUpdate();
 	}
 
 	if (const Item* item = thing->getItem()) {
@@ -3781,6 +3818,8 @@ void Player::postAddNotification(Thing* thing, const Cylinder* oldParent, int32_
 
 void Player::postRemoveNotification(Thing* thing, const Cylinder* newParent, int32_t index, cylinderlink_t link /*= LINK_OWNER*/)
 {
+	invalidateItemTypeCountIndex();
+
 	if (link == LINK_OWNER) {
 		//calling movement scripts
 		g_moveEvents->onPlayerDeEquip(this, thing->getItem(), static_cast<slots_t>(index));
@@ -3803,8 +3842,7 @@ void Player::postRemoveNotification(Thing* thing, const Cylinder* newParent, int
 
 		updateInventoryWeight();
 		updateItemsLight();
-		sendInvetoryItems();
-		sendStats();
+		scheduleInventoryUpdate();
 	}
 
 	if (const Item* item = thing->getItem()) {
@@ -3897,6 +3935,7 @@ void Player::internalAddThing(uint32_t index, Thing* thing)
 
 		inventory[index] = item;
 		item->setParent(this);
+		invalidateItemTypeCountIndex();
 	}
 }
 
@@ -4309,6 +4348,7 @@ bool Player::onKilledCreature(Creature* target, bool lastHit/* = true*/)
 	Creature::onKilledCreature(target, lastHit);
 
 	if (Player* targetPlayer = target->getPlayer()) {
+		CyclopediaCache::getInstance().invalidate(guid);
 		if (targetPlayer && targetPlayer->getZone() == ZONE_PVP) {
 			targetPlayer->setDropLoot(false);
 			targetPlayer->setSkillLoss(false);
@@ -6112,6 +6152,17 @@ void Player::sendInvetoryItems()
 	sendItems(tempInventoryMap);
 }
 
+void Player::scheduleInventoryUpdate()
+{
+	// a burst of moves (looting a corpse, emptying a backpack) only sends one update
+	if (scheduledInventoryUpdate || !client) {
+		return;
+	}
+
+	g_dispatcher.addTask(createTask(std::bind(&Game::updatePlayerInventory, &g_game, getID())));
+	scheduledInventoryUpdate = true;
+}
+
 SoundEffect_t Player::getHitSoundEffect()
 {
 	// Distance sound effects
@@ -212,6 +212,7 @@ class Player final : public Creature, public Cylinder
 		}
 
 		void sendInvetoryItems();
+		void scheduleInventoryUpdate();
 
 		void BestiarysendCharms() {
 			if (client) {
@@ -1860,6 +1861,10 @@ class Player final : public Creature, public Cylinder
 			return scheduledSaleUpdate;
 		}
 
+		void setScheduledInventoryUpdate(bool scheduled) {
+			scheduledInventoryUpdate = scheduled;
+		}
+
 		bool inPushEvent() {
 			return inEventMovePush;
 		}
@@ -2683,6 +2688,11 @@ void sendMessageDialog(const std::string& message) const
 
 		void updateInventoryWeight();
 
+		void invalidateItemTypeCountIndex() {
+			itemTypeCountIndexDirty = true;
+		}
+		void rebuildItemTypeCountIndex() const;
+
 		void setNextWalkActionTask(SchedulerTask* task);
 		void setNextWalkTask(SchedulerTask* task);
 		void setNextActionTask(SchedulerTask* task, bool resetIdleTime = true);
@@ -2752,6 +2762,8 @@ void sendMessageDialog(const std::string& message) const
 		};
 
 		std::map<ObjectCategory_t, Container*> quickLootContainers;
+		// itemId -> total count across inventory and nested containers, rebuilt lazily
+		mutable std::unordered_map<uint16_t, uint32_t> itemTypeCountIndex;
 		std::vector<uint16_t> quickLootListClientIds;
 
 		std::vector<OutfitEntry> outfits;
@@ -2942,6 +2954,8 @@ void sendMessageDialog(const std::string& message) const
 		bool quickLootFallbackToMainContainer = false;
 		bool logged = false;
 		bool scheduledSaleUpdate = false;
+		bool scheduledInventoryUpdate = false;
+		mutable bool itemTypeCountIndexDirty = true;
 		bool inEventMovePush = false;
 		bool supplyStash = false; // Menu option 'stow, stow container ...'
 		bool marketMenu = false; // Menu option 'show in market'
@@ -278,6 +278,19 @@ void Spawns::clear()
 	}
 	spawnList.clear();
 
+	// custom spawns stay alive, give them a fresh queue
+	spawnChecks = {};
+	for (Spawn& spawn : customSpawnList) {
+		if (spawn.getNextCheck() != 0) {
+			spawnChecks.push({spawn.getNextCheck(), &spawn});
+		}
+	}
+	if (checkSpawnsEvent != 0) {
+		g_scheduler.stopEvent(checkSpawnsEvent);
+		checkSpawnsEvent = 0;
+	}
+	scheduleNextCheck();
+
 	loaded = false;
 	started = false;
 	filename.clear();
@@ -293,34 +306,118 @@ bool Spawns::isInZone(const Position& centerPos, int32_t radius, const Position&
 	        (pos.getY() >= centerPos.getY() - radius) && (pos.getY() <= centerPos.getY() + radius));
 }
 
-void Spawn::startSpawnCheck()
+void Spawns::scheduleSpawnCheck(Spawn* spawn, uint32_t delay)
 {
-	if (checkSpawnEvent == 0) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), std::bind(&Spawn::checkSpawn, this)));
+	// round up so checks of many spawns share one scheduler event
+	int64_t time = OTSYS_TIME() + delay;
+	time += SPAWN_CHECK_GRANULARITY - (time % SPAWN_CHECK_GRANULARITY);
+
+	spawn->setNextCheck(time);
+	spawnChecks.push({time, spawn});
+	if (!checkingSpawns && (checkSpawnsEvent == 0 || time < checkSpawnsTime)) {
+		if (checkSpawnsEvent != 0) {
+			g_scheduler.stopEvent(checkSpawnsEvent);
+			checkSpawnsEvent = 0;
+		}
+		scheduleNextCheck();
 	}
 }
 
-Spawn::~Spawn()
+void Spawns::scheduleNextCheck()
 {
-	for (const auto& it : spawnedMap) {
-		Monster* monster = it.second;
-		monster->setSpawn(nullptr);
-		monster->decrementReferenceCounter();
+	if (spawnChecks.empty()) {
+		return;
+	}
+
+	checkSpawnsTime = spawnChecks.top().time;
+	int64_t delay = std::max<int64_t>(SCHEDULER_MINTICKS, checkSpawnsTime - OTSYS_TIME());
+	checkSpawnsEvent = g_scheduler.addEvent(createSchedulerTask(static_cast<uint32_t>(delay), std::bind(&Spawns::checkSpawns, this)));
+}
+
+void Spawns::checkSpawns()
+{
+	checkSpawnsEvent = 0;
+	checkingSpawns = true;
+
+	SpawnPlayerGrid playerGrid;
+	int64_t now = OTSYS_TIME();
+	while (!spawnChecks.empty() && spawnChecks.top().time <= now) {
+		SpawnCheck check = spawnChecks.top();
+		spawnChecks.pop();
+
+		Spawn* spawn = check.spawn;
+		if (spawn->getNextCheck() != check.time) {
+			continue;
+		}
+
+		spawn->setNextCheck(0);
+		spawn->checkSpawn(playerGrid);
 	}
+
+	checkingSpawns = false;
+	scheduleNextCheck();
 }
 
-bool Spawn::findPlayer(const Position& pos)
+bool SpawnPlayerGrid::hasPlayerNear(const Position& pos)
 {
-	SpectatorHashSet spectators;
-	g_game.map.getSpectators(spectators, pos, false, true);
-	for (Creature* spectator : spectators) {
-		if (!spectator->getPlayer()->hasFlag(PlayerFlag_IgnoredByMonsters)) {
-			return true;
+	if (!built) {
+		build();
+	}
+
+	if (cells.empty()) {
+		return false;
+	}
+
+	// same area as the single floor spectator query this replaces
+	int32_t cellX = pos.x / CELL_SIZE;
+	int32_t cellY = pos.y / CELL_SIZE;
+	for (int32_t x = cellX - 1; x <= cellX + 1; ++x) {
+		for (int32_t y = cellY - 1; y <= cellY + 1; ++y) {
+			auto it = cells.find(getCellKey(x, y, pos.z));
+			if (it == cells.end()) {
+				continue;
+			}
+
+			for (const Position& playerPos : it->second) {
+				if (Position::getDistanceX(pos, playerPos) <= Map::maxViewportX && Position::getDistanceY(pos, playerPos) <= Map::maxViewportY) {
+					return true;
+				}
+			}
 		}
 	}
 	return false;
 }
 
+void SpawnPlayerGrid::build()
+{
+	built = true;
+	for (const auto& it : g_game.getPlayers()) {
+		Player* player = it.second;
+		if (player->hasFlag(PlayerFlag_IgnoredByMonsters) || player->isRemoved()) {
+			continue;
+		}
+
+		const Position& playerPos = player->getPosition();
+		cells[getCellKey(playerPos.x / CELL_SIZE, playerPos.y / CELL_SIZE, playerPos.z)].push_back(playerPos);
+	}
+}
+
+void Spawn::startSpawnCheck()
+{
+	if (nextCheck == 0) {
+		g_game.map.spawns.scheduleSpawnCheck(this, getInterval());
+	}
+}
+
+Spawn::~Spawn()
+{
+	for (const auto& it : spawnedMap) {
+		Monster* monster = it.second;
+		monster->setSpawn(nullptr);
+		monster->decrementReferenceCounter();
+	}
+}
+
 bool Spawn::isInSpawnZone(const Position& pos)
 {
 	return Spawns::isInZone(centerPos, radius, pos);
@@ -368,10 +465,8 @@ void Spawn::startup()
 	}
 }
 
-void Spawn::checkSpawn()
+void Spawn::checkSpawn(SpawnPlayerGrid& playerGrid)
 {
-	checkSpawnEvent = 0;
-
 	cleanup();
 
 	uint32_t spawnCount = 0;
@@ -389,7 +484,7 @@ void Spawn::checkSpawn()
 		}
 
 		if (OTSYS_TIME() >= sb.lastSpawn + sb.interval) {
-			if (sb.mType->info.isBlockable && findPlayer(sb.pos)) {
+			if (sb.mType->info.isBlockable && playerGrid.hasPlayerNear(sb.pos)) {
 				sb.lastSpawn = OTSYS_TIME();
 				continue;
 			}
@@ -407,7 +502,7 @@ void Spawn::checkSpawn()
 	}
 
 	if (spawnedMap.size() < spawnMap.size()) {
-		checkSpawnEvent = g_scheduler.addEvent(createSchedulerTask(getInterval(), std::bind(&Spawn::checkSpawn, this)));
+		startSpawnCheck();
 	}
 }
 
@@ -472,8 +567,6 @@ void Spawn::removeMonster(Monster* monster)
 
 void Spawn::stopEvent()
 {
-	if (checkSpawnEvent != 0) {
-		g_scheduler.stopEvent(checkSpawnEvent);
-		checkSpawnEvent = 0;
-	}
+	// the queued check is skipped once its time no longer matches
+	nextCheck = 0;
 }
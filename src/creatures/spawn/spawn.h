@@ -23,10 +23,32 @@
 #include "items/tile.h"
 #include "game/movement/position.h"
 
+#include <queue>
+
 class Monster;
 class MonsterType;
 class Npc;
 
+// Players that block spawns, bucketed by map region. Built at most once per
+// batch of spawn checks instead of running a spectator query per spawn block.
+class SpawnPlayerGrid
+{
+	public:
+		bool hasPlayerNear(const Position& pos);
+
+	private:
+		static constexpr int32_t CELL_SIZE = 16;
+
+		static uint64_t getCellKey(int32_t cellX, int32_t cellY, uint8_t z) {
+			return (static_cast<uint64_t>(cellX & 0xFFFF) << 24) | (static_cast<uint64_t>(cellY & 0xFFFF) << 8) | z;
+		}
+
+		void build();
+
+		std::unordered_map<uint64_t, std::vector<Position>> cells;
+		bool built = false;
+};
+
 struct spawnBlock_t {
 	Position pos;
 	MonsterType* mType;
@@ -55,10 +77,18 @@ class Spawn
 
 		void startSpawnCheck();
 		void stopEvent();
+		void checkSpawn(SpawnPlayerGrid& playerGrid);
 
 		bool isInSpawnZone(const Position& pos);
 		void cleanup();
 
+		int64_t getNextCheck() const {
+			return nextCheck;
+		}
+		void setNextCheck(int64_t time) {
+			nextCheck = time;
+		}
+
 	private:
 		//map of the spawned creatures
 		using SpawnedMap = std::multimap<uint32_t, Monster*>;
@@ -72,11 +102,10 @@ class Spawn
 		int32_t radius;
 
 		uint32_t interval = 60000;
-		uint32_t checkSpawnEvent = 0;
+		// due time of the pending check in Spawns, 0 when none is scheduled
+		int64_t nextCheck = 0;
 
-		static bool findPlayer(const Position& pos);
 		bool spawnMonster(uint32_t spawnId, MonsterType* mType, const Position& pos, Direction dir, bool startup = false);
-		void checkSpawn();
 		void scheduleSpawn(uint32_t spawnId, spawnBlock_t& sb, uint16_t interval);
 };
 
@@ -97,7 +126,29 @@ class Spawns
 		}
 
 		bool loadCustomSpawnXml(const std::string& _filename);
+
+		void scheduleSpawnCheck(Spawn* spawn, uint32_t delay);
+
 	private:
+		struct SpawnCheck {
+			int64_t time;
+			Spawn* spawn;
+
+			bool operator>(const SpawnCheck& other) const {
+				return time > other.time;
+			}
+		};
+
+		void checkSpawns();
+		void scheduleNextCheck();
+
+		// pending spawn checks ordered by due time, entries whose time no longer
+		// matches Spawn::getNextCheck were cancelled or rescheduled and are skipped
+		std::priority_queue<SpawnCheck, std::vector<SpawnCheck>, std::greater<SpawnCheck>> spawnChecks;
+		int64_t checkSpawnsTime = 0;
+		uint32_t checkSpawnsEvent = 0;
+		bool checkingSpawns = false;
+
 		std::forward_list<Npc*> npcList;
 		std::forward_list<Spawn> spawnList;
 		std::string filename;
@@ -108,5 +159,7 @@ class Spawns
 };
 
 static constexpr int32_t NONBLOCKABLE_SPAWN_INTERVAL = 1400;
+// spawn checks due within the same window run in one scheduler event
+static constexpr int32_t SPAWN_CHECK_GRANULARITY = 1000;
 
 #endif
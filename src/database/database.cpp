@@ -143,9 +143,8 @@ bool Database::executeQuery(const std::string& query)
 	// executes the query
 	databaseLock.lock();
 
-#ifdef STATS_ENABLED
+	TraceSpan span("sql");
 	std::chrono::high_resolution_clock::time_point time_point = std::chrono::high_resolution_clock::now();
-#endif
 
 	while (mysql_real_query(handle, query.c_str(), query.length()) != 0) {
 		SPDLOG_ERROR("Query: {}", query.substr(0, 256));
@@ -160,8 +159,9 @@ bool Database::executeQuery(const std::string& query)
 
 	MYSQL_RES* m_res = mysql_store_result(handle);
 
-#ifdef STATS_ENABLED
 	uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - time_point).count();
+	g_metrics.record(METRIC_SQL_QUERY, ns);
+#ifdef STATS_ENABLED
 	g_stats.addSqlStats(new Stat(ns, query.substr(0, 100), query.substr(0, 256)));
 #endif
 
@@ -183,9 +183,8 @@ DBResult_ptr Database::storeQuery(const std::string& query)
 
 	databaseLock.lock();
 
-#ifdef STATS_ENABLED
-  std::chrono::high_resolution_clock::time_point time_point = std::chrono::high_resolution_clock::now();
-#endif
+	TraceSpan span("sql");
+	std::chrono::high_resolution_clock::time_point time_point = std::chrono::high_resolution_clock::now();
 
 	retry:
 	while (mysql_real_query(handle, query.c_str(), query.length()) != 0) {
@@ -212,8 +211,9 @@ DBResult_ptr Database::storeQuery(const std::string& query)
 		goto retry;
 	}
 
-#ifdef STATS_ENABLED
 	uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - time_point).count();
+	g_metrics.record(METRIC_SQL_QUERY, ns);
+#ifdef STATS_ENABLED
 	g_stats.addSqlStats(new Stat(ns, query.substr(0, 100), query.substr(0, 256)));
 #endif
 
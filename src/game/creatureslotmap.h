@@ -0,0 +1,129 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_CREATURESLOTMAP_H_4F1A7C3E9B2D4E8A6C5B0D7F1E3A9C26
+#define FS_CREATURESLOTMAP_H_4F1A7C3E9B2D4E8A6C5B0D7F1E3A9C26
+
+#include <deque>
+
+/**
+ * Registry of the creatures of one kind currently in the game. A creature id
+ * is base | generation << INDEX_BITS | index: looking one up is a bounds check
+ * and one comparison against the slot, and the generation changes whenever a
+ * slot is freed so ids of removed creatures are never resolved again. Freed
+ * slots are reused oldest first and only once MIN_FREE_SLOTS others are
+ * waiting, so an id comes back after at least MIN_FREE_SLOTS << GENERATION_BITS
+ * removals. Clients and scripts may still hold an id that long. The creatures
+ * themselves are kept packed in a vector.
+ */
+template<typename T>
+class CreatureSlotMap
+{
+	public:
+		// the largest maps spawn over 128k monsters at once
+		static constexpr uint32_t INDEX_BITS = 18;
+		static constexpr uint32_t GENERATION_BITS = 12;
+		static constexpr size_t MIN_FREE_SLOTS = 16384;
+		static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+		// base holds the bits above INDEX_BITS + GENERATION_BITS
+		explicit CreatureSlotMap(uint32_t base) : base(base) {}
+
+		// non-copyable
+		CreatureSlotMap(const CreatureSlotMap&) = delete;
+		CreatureSlotMap& operator=(const CreatureSlotMap&) = delete;
+
+		// returns the id of the creature, 0 when every slot is taken
+		uint32_t insert(T* creature) {
+			uint32_t index;
+			if (freeSlots.size() > MIN_FREE_SLOTS || (!freeSlots.empty() && slots.size() > INDEX_MASK)) {
+				index = freeSlots.front();
+				freeSlots.pop_front();
+			} else if (slots.size() <= INDEX_MASK) {
+				index = static_cast<uint32_t>(slots.size());
+				slots.emplace_back();
+			} else {
+				return 0;
+			}
+
+			Slot& slot = slots[index];
+			slot.id = base | (slot.generation << INDEX_BITS) | index;
+			slot.denseIndex = static_cast<uint32_t>(dense.size());
+			dense.push_back(creature);
+			denseSlots.push_back(index);
+			return slot.id;
+		}
+
+		void erase(uint32_t id) {
+			uint32_t index = id & INDEX_MASK;
+			if (index >= slots.size() || slots[index].id != id) {
+				return;
+			}
+
+			// keep the creatures packed by moving the last one into the hole
+			Slot& slot = slots[index];
+			uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+			if (slot.denseIndex != last) {
+				dense[slot.denseIndex] = dense[last];
+				denseSlots[slot.denseIndex] = denseSlots[last];
+				slots[denseSlots[last]].denseIndex = slot.denseIndex;
+			}
+			dense.pop_back();
+			denseSlots.pop_back();
+
+			slot.id = 0;
+			slot.generation = (slot.generation + 1) & GENERATION_MASK;
+			freeSlots.push_back(index);
+		}
+
+		T* get(uint32_t id) const {
+			uint32_t index = id & INDEX_MASK;
+			if (index >= slots.size() || slots[index].id != id || id == 0) {
+				return nullptr;
+			}
+			return dense[slots[index].denseIndex];
+		}
+
+		size_t size() const {
+			return dense.size();
+		}
+
+		typename std::vector<T*>::const_iterator begin() const {
+			return dense.begin();
+		}
+		typename std::vector<T*>::const_iterator end() const {
+			return dense.end();
+		}
+
+	private:
+		struct Slot {
+			uint32_t id = 0;
+			uint32_t denseIndex = 0;
+			uint32_t generation = 0;
+		};
+
+		std::vector<Slot> slots;
+		std::vector<T*> dense;
+		std::vector<uint32_t> denseSlots;
+		std::deque<uint32_t> freeSlots;
+		const uint32_t base;
+};
+
+#endif
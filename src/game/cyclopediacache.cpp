@@ -0,0 +1,100 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "game/cyclopediacache.h"
+
+#include "utils/tools.h"
+
+const CyclopediaCache::Page* CyclopediaCache::get(uint32_t guid, CyclopediaCharacterInfoType_t type, uint16_t page, uint16_t entriesPerPage)
+{
+	int64_t now = OTSYS_TIME();
+	if (now - lastStats >= STATS_INTERVAL) {
+		logStats();
+		lastStats = now;
+	}
+
+	auto it = index.find(makeKey(guid, type, page));
+	if (it == index.end()) {
+		++misses;
+		return nullptr;
+	}
+
+	auto entry = it->second;
+	if (entry->entriesPerPage != entriesPerPage || entry->expiresAt <= now) {
+		erase(entry);
+		++misses;
+		return nullptr;
+	}
+
+	entries.splice(entries.begin(), entries, entry);
+	++hits;
+	return &entry->value;
+}
+
+void CyclopediaCache::put(uint32_t guid, CyclopediaCharacterInfoType_t type, uint16_t page, uint16_t entriesPerPage, uint64_t generation, Page&& value)
+{
+	if (generation != this->generation) {
+		return;
+	}
+
+	uint64_t key = makeKey(guid, type, page);
+	auto it = index.find(key);
+	if (it != index.end()) {
+		erase(it->second);
+	}
+
+	if (entries.size() >= MAX_ENTRIES) {
+		erase(std::prev(entries.end()));
+	}
+
+	entries.push_front({key, guid, entriesPerPage, OTSYS_TIME() + ENTRY_LIFETIME, std::move(value)});
+	index[key] = entries.begin();
+}
+
+void CyclopediaCache::invalidate(uint32_t guid)
+{
+	++generation;
+	for (auto it = entries.begin(); it != entries.end(); ) {
+		auto next = std::next(it);
+		if (it->guid == guid) {
+			erase(it);
+		}
+		it = next;
+	}
+}
+
+void CyclopediaCache::erase(std::list<Entry>::iterator it)
+{
+	index.erase(it->key);
+	entries.erase(it);
+}
+
+void CyclopediaCache::logStats()
+{
+	uint64_t requests = hits + misses;
+	if (requests == 0) {
+		return;
+	}
+
+	SPDLOG_DEBUG("[CyclopediaCache::logStats] - {} requests, {:.1f}% hits, {} entries", requests, hits * 100.0 / requests, entries.size());
+	hits = 0;
+	misses = 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_CYCLOPEDIACACHE_H_3E8A1F6C2B9D4A7E5C0B8D1F2A6E9C4B
+#define FS_CYCLOPEDIACACHE_H_3E8A1F6C2B9D4A7E5C0B8D1F2A6E9C4B
+
+#include <list>
+
+#include "utils/enums.h"
+
+/**
+ * Least recently used cache of the database backed cyclopedia pages (recent
+ * deaths and pvp kills). Entries of a character are dropped whenever it dies
+ * or kills another player, so flipping pages back and forth does not run the
+ * same queries again.
+ */
+class CyclopediaCache
+{
+	public:
+		static CyclopediaCache& getInstance() {
+			static CyclopediaCache instance;
+			return instance;
+		}
+
+		struct Page {
+			uint16_t pages = 0;
+			std::vector<RecentDeathEntry> deaths;
+			std::vector<RecentPvPKillEntry> kills;
+		};
+
+		const Page* get(uint32_t guid, CyclopediaCharacterInfoType_t type, uint16_t page, uint16_t entriesPerPage);
+		// generation is the value of getGeneration() when the query was issued,
+		// results that raced with an invalidation are not stored
+		void put(uint32_t guid, CyclopediaCharacterInfoType_t type, uint16_t page, uint16_t entriesPerPage, uint64_t generation, Page&& value);
+		void invalidate(uint32_t guid);
+
+		uint64_t getGeneration() const {
+			return generation;
+		}
+
+	private:
+		CyclopediaCache() = default;
+
+		static constexpr size_t MAX_ENTRIES = 1024;
+		static constexpr int64_t ENTRY_LIFETIME = 5 * 60 * 1000;
+		static constexpr int64_t STATS_INTERVAL = 10 * 60 * 1000;
+
+		struct Entry {
+			uint64_t key;
+			uint32_t guid;
+			uint16_t entriesPerPage;
+			int64_t expiresAt;
+			Page value;
+		};
+
+		static uint64_t makeKey(uint32_t guid, CyclopediaCharacterInfoType_t type, uint16_t page) {
+			return static_cast<uint64_t>(guid) | (static_cast<uint64_t>(type) << 32) | (static_cast<uint64_t>(page) << 40);
+		}
+
+		void erase(std::list<Entry>::iterator it);
+		void logStats();
+
+		// most recently used entry first
+		std::list<Entry> entries;
+		std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+		uint64_t generation = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		int64_t lastStats = 0;
+};
+
+#endif
@@ -29,7 +29,10 @@
 #include "database/databasetasks.h"
 #include "lua/creature/events.h"
 #include "game/game.h"
+#include "game/cyclopediacache.h"
 #include "lua/global/globalevent.h"
+#include "io/iohighscores.h"
+#include "io/iomap.h"
 #include "io/iologindata.h"
 #include "io/iomarket.h"
 #include "items/items.h"
@@ -676,9 +679,9 @@ bool Game::loadMainMap(const std::string& filename)
 	return map.loadMap("data/world/" + filename + ".otbm", true, true);
 }
 
-void Game::loadMap(const std::string& path)
+void Game::loadMap(const std::string& path, std::function<void(bool)> onLoaded /* = nullptr*/)
 {
-	map.loadMap(path, false, false);
+	IOMap::loadMapPatch(path, std::move(onLoaded));
 }
 
 bool Game::loadCustomSpawnFile(const std::string& fileName)
@@ -859,38 +862,20 @@ Creature* Game::getCreatureByID(uint32_t id)
 {
 	if (id <= Player::playerAutoID) {
 		return getPlayerByID(id);
-	} else if (id <= Monster::monsterAutoID) {
-		return getMonsterByID(id);
-	} else if (id <= Npc::npcAutoID) {
-		return getNpcByID(id);
+	} else if (id < 0x80000000) {
+		return monsters.get(id);
 	}
-	return nullptr;
+	return npcs.get(id);
 }
 
 Monster* Game::getMonsterByID(uint32_t id)
 {
-	if (id == 0) {
-		return nullptr;
-	}
-
-	auto it = monsters.find(id);
-	if (it == monsters.end()) {
-		return nullptr;
-	}
-	return it->second;
+	return monsters.get(id);
 }
 
 Npc* Game::getNpcByID(uint32_t id)
 {
-	if (id == 0) {
-		return nullptr;
-	}
-
-	auto it = npcs.find(id);
-	if (it == npcs.end()) {
-		return nullptr;
-	}
-	return it->second;
+	return npcs.get(id);
 }
 
 Player* Game::getPlayerByID(uint32_t id)
@@ -919,15 +904,15 @@ Creature* Game::getCreatureByName(const std::string& s)
 		return m_it->second;
 	}
 
-	for (const auto& it : npcs) {
-		if (lowerCaseName == asLowerCaseString(it.second->getName())) {
-			return it.second;
+	for (Npc* npc : npcs) {
+		if (lowerCaseName == asLowerCaseString(npc->getName())) {
+			return npc;
 		}
 	}
 
-	for (const auto& it : monsters) {
-		if (lowerCaseName == asLowerCaseString(it.second->getName())) {
-			return it.second;
+	for (Monster* monster : monsters) {
+		if (lowerCaseName == asLowerCaseString(monster->getName())) {
+			return monster;
 		}
 	}
 	return nullptr;
@@ -940,9 +925,9 @@ Npc* Game::getNpcByName(const std::string& s)
 	}
 
 	const char* npcName = s.c_str();
-	for (const auto& it : npcs) {
-		if (strcasecmp(npcName, it.second->getName().c_str()) == 0) {
-			return it.second;
+	for (Npc* npc : npcs) {
+		if (strcasecmp(npcName, npc->getName().c_str()) == 0) {
+			return npc;
 		}
 	}
 	return nullptr;
@@ -1633,6 +1618,7 @@ void Game::playerMoveItem(Player* player, const Position& fromPos,
 ReturnValue Game::internalMoveItem(Cylinder* fromCylinder, Cylinder* toCylinder, int32_t index,
 								   Item* item, uint32_t count, Item** _moveItem, uint32_t flags /*= 0*/, Creature* actor/* = nullptr*/, Item* tradeItem/* = nullptr*/)
 {
+	TraceSpan span("internalMoveItem", item->getID());
 	Tile* fromTile = fromCylinder->getTile();
 	if (fromTile) {
 		auto it = browseFields.find(fromTile);
@@ -5467,10 +5453,20 @@ void Game::checkCreatures(size_t index)
 		Creature* creature = checkCreatureList[it];
 		if (creature && creature->creatureCheck) {
 			if (creature->getHealth() > 0) {
-				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
-				creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
-				creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
+				{
+					TraceSpan span("onThink", creature->getID());
+					creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
+				}
+				{
+					TraceSpan span("onAttacking", creature->getID());
+					creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
+				}
+				{
+					TraceSpan span("executeConditions", creature->getID());
+					creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
+				}
 			} else {
+				TraceSpan span("onDeath", creature->getID());
 				creature->onDeath();
 			}
 			++it;
@@ -5484,7 +5480,16 @@ void Game::checkCreatures(size_t index)
 		}
 	}
 
-	cleanup();
+	{
+		TraceSpan span("cleanup");
+		cleanup();
+	}
+
+	for (Party* party : partyStatusUpdates) {
+		party->sendStatusUpdates();
+	}
+	partyStatusUpdates.clear();
+
 	g_stats.playersOnline = getPlayersOnline();
 }
 
@@ -7072,6 +7077,7 @@ bool Game::gameIsDay()
 void Game::shutdown()
 {
   webhook_send_message("Server is shutting down", "Shutting down...", WEBHOOK_COLOR_OFFLINE);
+	webhook_shutdown();
 
 	SPDLOG_INFO("Shutting down...");
 	
@@ -7493,12 +7499,19 @@ void Game::playerCyclopediaCharacterInfo(Player* player, uint32_t characterID, C
 	case CYCLOPEDIA_CHARACTERINFO_GENERALSTATS: player->sendCyclopediaCharacterGeneralStats(); break;
 	case CYCLOPEDIA_CHARACTERINFO_COMBATSTATS: player->sendCyclopediaCharacterCombatStats(); break;
   case CYCLOPEDIA_CHARACTERINFO_RECENTDEATHS: {
+			CyclopediaCache& cache = CyclopediaCache::getInstance();
+			if (const CyclopediaCache::Page* cached = cache.get(playerGUID, characterInfoType, page, entriesPerPage)) {
+				player->sendCyclopediaCharacterRecentDeaths(page, cached->pages, cached->deaths);
+				break;
+			}
+
     std::ostringstream query;
     uint32_t offset = static_cast<uint32_t>(page - 1) * entriesPerPage;
 			query << "SELECT `time`, `level`, `killed_by`, `mostdamage_by`, (select count(*) FROM `player_deaths` WHERE `player_id` = " << playerGUID << ") as `entries` FROM `player_deaths` WHERE `player_id` = " << playerGUID << " ORDER BY `time` DESC LIMIT " << offset << ", " << entriesPerPage;
 
 			uint32_t playerID = player->getID();
-			std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](DBResult_ptr result, bool) {
+			uint64_t generation = cache.getGeneration();
+			std::function<void(DBResult_ptr, bool)> callback = [playerID, playerGUID, page, entriesPerPage, generation](DBResult_ptr result, bool) {
 				Player* player = g_game.getPlayerByID(playerID);
 				if (!player) {
 					return;
@@ -7549,6 +7562,11 @@ void Game::playerCyclopediaCharacterInfo(Player* player, uint32_t characterID, C
 					entries.emplace_back(std::move(cause.str()), result->getNumber<uint32_t>("time"));
 				} while (result->next());
 				player->sendCyclopediaCharacterRecentDeaths(page, static_cast<uint16_t>(pages), entries);
+
+				CyclopediaCache::Page cached;
+				cached.pages = static_cast<uint16_t>(pages);
+				cached.deaths = std::move(entries);
+				CyclopediaCache::getInstance().put(playerGUID, CYCLOPEDIA_CHARACTERINFO_RECENTDEATHS, page, entriesPerPage, generation, std::move(cached));
 			};
 			g_databaseTasks.addTask(std::move(query.str()), callback, true);
 			player->addAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
@@ -7556,6 +7574,12 @@ void Game::playerCyclopediaCharacterInfo(Player* player, uint32_t characterID, C
 	}
 	case CYCLOPEDIA_CHARACTERINFO_RECENTPVPKILLS: {
 			// TODO: add guildwar, assists and arena kills
+			CyclopediaCache& cache = CyclopediaCache::getInstance();
+			if (const CyclopediaCache::Page* cached = cache.get(playerGUID, characterInfoType, page, entriesPerPage)) {
+				player->sendCyclopediaCharacterRecentPvPKills(page, cached->pages, cached->kills);
+				break;
+			}
+
 			Database& db = Database::getInstance();
 			const std::string& escapedName = db.escapeString(player->getName());
 			std::ostringstream query;
@@ -7563,7 +7587,8 @@ void Game::playerCyclopediaCharacterInfo(Player* player, uint32_t characterID, C
 			query << "SELECT `d`.`time`, `d`.`killed_by`, `d`.`mostdamage_by`, `d`.`unjustified`, `d`.`mostdamage_unjustified`, `p`.`name`, (select count(*) FROM `player_deaths` WHERE ((`killed_by` = " << escapedName << " AND `is_player` = 1) OR (`mostdamage_by` = " << escapedName << " AND `mostdamage_is_player` = 1))) as `entries` FROM `player_deaths` AS `d` INNER JOIN `players` AS `p` ON `d`.`player_id` = `p`.`id` WHERE ((`d`.`killed_by` = " << escapedName << " AND `d`.`is_player` = 1) OR (`d`.`mostdamage_by` = " << escapedName << " AND `d`.`mostdamage_is_player` = 1)) ORDER BY `time` DESC LIMIT " << offset << ", " << entriesPerPage;
 
 			uint32_t playerID = player->getID();
-			std::function<void(DBResult_ptr, bool)> callback = [playerID, page, entriesPerPage](DBResult_ptr result, bool) {
+			uint64_t generation = cache.getGeneration();
+			std::function<void(DBResult_ptr, bool)> callback = [playerID, playerGUID, page, entriesPerPage, generation](DBResult_ptr result, bool) {
 				Player* player = g_game.getPlayerByID(playerID);
 				if (!player) {
 					return;
@@ -7602,6 +7627,11 @@ void Game::playerCyclopediaCharacterInfo(Player* player, uint32_t characterID, C
 					entries.emplace_back(std::move(description.str()), result->getNumber<uint32_t>("time"), status);
 				} while (result->next());
 				player->sendCyclopediaCharacterRecentPvPKills(page, static_cast<uint16_t>(pages), entries);
+
+				CyclopediaCache::Page cached;
+				cached.pages = static_cast<uint16_t>(pages);
+				cached.kills = std::move(entries);
+				CyclopediaCache::getInstance().put(playerGUID, CYCLOPEDIA_CHARACTERINFO_RECENTPVPKILLS, page, entriesPerPage, generation, std::move(cached));
 			};
 			g_databaseTasks.addTask(std::move(query.str()), callback, true);
 			player->addAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills);
@@ -7620,105 +7650,25 @@ void Game::playerCyclopediaCharacterInfo(Player* player, uint32_t characterID, C
 
 void Game::playerHighscores(Player* player, HighscoreType_t type, uint8_t category, uint32_t vocation, const std::string&, uint16_t page, uint8_t entriesPerPage)
 {
-	if (player->hasAsyncOngoingTask(PlayerAsyncTask_Highscore)) {
-		return;
+	if (category > HIGHSCORE_CATEGORY_MAGIC_LEVEL) {
+		category = HIGHSCORE_CATEGORY_EXPERIENCE;
 	}
 
-	std::string categoryName;
-	switch (category) {
-		case HIGHSCORE_CATEGORY_FIST_FIGHTING: categoryName = "skill_fist"; break;
-		case HIGHSCORE_CATEGORY_CLUB_FIGHTING: categoryName = "skill_club"; break;
-		case HIGHSCORE_CATEGORY_SWORD_FIGHTING: categoryName = "skill_sword"; break;
-		case HIGHSCORE_CATEGORY_AXE_FIGHTING: categoryName = "skill_axe"; break;
-		case HIGHSCORE_CATEGORY_DISTANCE_FIGHTING: categoryName = "skill_dist"; break;
-		case HIGHSCORE_CATEGORY_SHIELDING: categoryName = "skill_shielding"; break;
-		case HIGHSCORE_CATEGORY_FISHING: categoryName = "skill_fishing"; break;
-		case HIGHSCORE_CATEGORY_MAGIC_LEVEL: categoryName = "maglevel"; break;
-		default: {
-			category = HIGHSCORE_CATEGORY_EXPERIENCE;
-			categoryName = "experience";
-			break;
-		}
+	IOHighscores& highscores = IOHighscores::getInstance();
+	if (type == HIGHSCORE_OURRANK) {
+		page = highscores.getPlayerPage(category, vocation, player->getGUID(), entriesPerPage);
+	} else if (type != HIGHSCORE_GETENTRIES) {
+		player->sendHighscoresNoData();
+		return;
 	}
 
-	std::ostringstream query;
-	if (type == HIGHSCORE_GETENTRIES) {
-		uint32_t startPage = (static_cast<uint32_t>(page - 1) * static_cast<uint32_t>(entriesPerPage));
-		uint32_t endPage = startPage + static_cast<uint32_t>(entriesPerPage);
-		query << "SELECT *, @row AS `entries`, " << page << " AS `page` FROM (SELECT *, (@row := @row + 1) AS `rn` FROM (SELECT `id`, `name`, `level`, `vocation`, `" << categoryName << "` AS `points`, @curRank := IF(@prevRank = `" << categoryName << "`, @curRank, IF(@prevRank := `" << categoryName << "`, @curRank + 1, @curRank + 1)) AS `rank` FROM `players` `p`, (SELECT @curRank := 0, @prevRank := NULL, @row := 0) `r` WHERE `group_id` < " << static_cast<int>(account::GroupType::GROUP_TYPE_GAMEMASTER) << " ORDER BY `" << categoryName << "` DESC) `t`";
-		if (vocation != 0xFFFFFFFF) {
-			bool firstVocation = true;
-
-			const auto& vocationsMap = g_vocations.getVocations();
-			for (const auto& it : vocationsMap) {
-				const Vocation& voc = it.second;
-				if (voc.getFromVocation() == vocation) {
-					if (firstVocation) {
-						query << " WHERE `vocation` = " << voc.getId();
-						firstVocation = false;
-					} else {
-						query << " OR `vocation` = " << voc.getId();
-					}
-				}
-			}
-		}
-		query << ") `T` WHERE `rn` > " << startPage << " AND `rn` <= " << endPage;
-	} else if (type == HIGHSCORE_OURRANK) {
-		std::string entriesStr = std::to_string(entriesPerPage);
-		query << "SELECT *, @row AS `entries`, (@ourRow DIV " << entriesStr << ") + 1 AS `page` FROM (SELECT *, (@row := @row + 1) AS `rn`, @ourRow := IF(`id` = " << player->getGUID() << ", @row - 1, @ourRow) AS `rw` FROM (SELECT `id`, `name`, `level`, `vocation`, `" << categoryName << "` AS `points`, @curRank := IF(@prevRank = `" << categoryName << "`, @curRank, IF(@prevRank := `" << categoryName << "`, @curRank + 1, @curRank + 1)) AS `rank` FROM `players` `p`, (SELECT @curRank := 0, @prevRank := NULL, @row := 0, @ourRow := 0) `r` WHERE `group_id` < " << static_cast<int>(account::GroupType::GROUP_TYPE_GAMEMASTER) << " ORDER BY `" << categoryName << "` DESC) `t`";
-		if (vocation != 0xFFFFFFFF) {
-			bool firstVocation = true;
-
-			const auto& vocationsMap = g_vocations.getVocations();
-			for (const auto& it : vocationsMap) {
-				const Vocation& voc = it.second;
-				if (voc.getFromVocation() == vocation) {
-					if (firstVocation) {
-						query << " WHERE `vocation` = " << voc.getId();
-						firstVocation = false;
-					} else {
-						query << " OR `vocation` = " << voc.getId();
-					}
-				}
-			}
-		}
-		query << ") `T` WHERE `rn` > ((@ourRow DIV " << entriesStr << ") * " << entriesStr << ") AND `rn` <= (((@ourRow DIV " << entriesStr << ") * " << entriesStr << ") + " << entriesStr << ")";
+	std::vector<HighscoreCharacter> characters;
+	uint16_t pages;
+	if (!highscores.getEntries(category, vocation, page, entriesPerPage, characters, pages)) {
+		player->sendHighscoresNoData();
+		return;
 	}
-
-	uint32_t playerID = player->getID();
-	std::function<void(DBResult_ptr, bool)> callback = [playerID, category, vocation, entriesPerPage](DBResult_ptr result, bool) {
-		Player* player = g_game.getPlayerByID(playerID);
-		if (!player) {
-			return;
-		}
-
-		player->resetAsyncOngoingTask(PlayerAsyncTask_Highscore);
-		if (!result) {
-			player->sendHighscoresNoData();
-			return;
-		}
-
-		uint16_t page = result->getNumber<uint16_t>("page");
-		uint32_t pages = result->getNumber<uint32_t>("entries");
-		pages += entriesPerPage - 1;
-		pages /= entriesPerPage;
-
-		std::vector<HighscoreCharacter> characters;
-		characters.reserve(result->countResults());
-		do {
-			uint8_t characterVocation;
-			Vocation* voc = g_vocations.getVocation(result->getNumber<uint16_t>("vocation"));
-			if (voc) {
-				characterVocation = voc->getClientId();
-			} else {
-				characterVocation = 0;
-			}
-			characters.emplace_back(std::move(result->getString("name")), result->getNumber<uint64_t>("points"), result->getNumber<uint32_t>("id"), result->getNumber<uint32_t>("rank"), result->getNumber<uint16_t>("level"), characterVocation);
-		} while (result->next());
-		player->sendHighscores(characters, category, vocation, page, static_cast<uint16_t>(pages));
-	};
-	g_databaseTasks.addTask(std::move(query.str()), callback, true);
-	player->addAsyncOngoingTask(PlayerAsyncTask_Highscore);
+	player->sendHighscores(characters, category, vocation, page, pages);
 }
 
 void Game::playerTournamentLeaderboard(uint32_t playerId, uint8_t leaderboardType) {
@@ -8940,6 +8890,18 @@ void Game::updatePlayerSaleItems(uint32_t playerId)
 	player->setScheduledSaleUpdate(false);
 }
 
+void Game::updatePlayerInventory(uint32_t playerId)
+{
+	Player* player = getPlayerByID(playerId);
+	if (!player) {
+		return;
+	}
+
+	player->setScheduledInventoryUpdate(false);
+	player->sendInvetoryItems();
+	player->sendStats();
+}
+
 void Game::addPlayer(Player* player)
 {
 	const std::string& lowercase_name = asLowerCaseString(player->getName());
@@ -8956,9 +8918,13 @@ void Game::removePlayer(Player* player)
 	players.erase(player->getID());
 }
 
-void Game::addNpc(Npc* npc)
+uint32_t Game::addNpc(Npc* npc)
 {
-	npcs[npc->getID()] = npc;
+	uint32_t id = npcs.insert(npc);
+	if (id == 0) {
+		SPDLOG_ERROR("[Game::addNpc] - No free npc id left for {}", npc->getName());
+	}
+	return id;
 }
 
 void Game::removeNpc(Npc* npc)
@@ -8966,9 +8932,13 @@ void Game::removeNpc(Npc* npc)
 	npcs.erase(npc->getID());
 }
 
-void Game::addMonster(Monster* monster)
+uint32_t Game::addMonster(Monster* monster)
 {
-	monsters[monster->getID()] = monster;
+	uint32_t id = monsters.insert(monster);
+	if (id == 0) {
+		SPDLOG_ERROR("[Game::addMonster] - No free monster id left for {}", monster->getName());
+	}
+	return id;
 }
 
 void Game::removeMonster(Monster* monster)
@@ -9226,11 +9196,11 @@ void Game::spawnFiendishMonster(uint32_t clearId /* = 0*/)
 
   Start:
 
-	uint32_t id = uniform_random(1, monsters.size());
-	auto it = monsters.begin();
-	std::advance(it, id);
+	if (monsters.size() == 0) {
+		return;
+	}
 
-	Monster* monster = getMonsterByID(it->first);
+	Monster* monster = *(monsters.begin() + uniform_random(0, monsters.size() - 1));
 	if (!monster || monster->isRemoved() || monster->isInfluenced()) {
 		goto Start;
 	}
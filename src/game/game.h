@@ -33,6 +33,7 @@
 #include "lua/creature/raids.h"
 #include "creatures/npc/npc.h"
 #include "utils/wildcardtree.h"
+#include "game/creatureslotmap.h"
 #include "io/ioprey.h"
 #include "game/gamestore.h"
 #include "io/iobestiary.h"
@@ -99,7 +100,7 @@ class Game
 		void forceRemoveCondition(uint32_t creatureId, ConditionType_t type);
 
 		bool loadMainMap(const std::string& filename);
-		void loadMap(const std::string& path);
+		void loadMap(const std::string& path, std::function<void(bool)> onLoaded = nullptr);
 		bool loadCustomSpawnFile(const std::string& fileName);
 
 		/**
@@ -374,6 +375,7 @@ class Game
 		void playerTournamentLeaderboard(uint32_t playerId, uint8_t leaderboardType);
 
 		void updatePlayerSaleItems(uint32_t playerId);
+		void updatePlayerInventory(uint32_t playerId);
 
 		bool internalStartTrade(Player* player, Player* partner, Item* tradeItem);
 		void internalCloseTrade(Player* player);
@@ -571,16 +573,17 @@ class Game
 
 		const std::map<uint16_t, uint32_t>& getItemsPrice() const { return itemsPriceMap; }
 		const std::unordered_map<uint32_t, Player*>& getPlayers() const { return players; }
-		const std::map<uint32_t, Npc*>& getNpcs() const { return npcs; }
+		const CreatureSlotMap<Npc>& getNpcs() const { return npcs; }
 
 		void addPlayer(Player* player);
 		void removePlayer(Player* player);
 
-		void addNpc(Npc* npc);
+		// both return the id given to the creature
+		uint32_t addNpc(Npc* npc);
 		void removeNpc(Npc* npc);
 
-		void addMonster(Monster* npc);
-		void removeMonster(Monster* npc);
+		uint32_t addMonster(Monster* monster);
+		void removeMonster(Monster* monster);
 
 		Guild* getGuild(uint32_t id) const;
 		void addGuild(Guild* guild);
@@ -622,6 +625,13 @@ class Game
 		//Follow
 		void checkFollow(bool thread);
 		void addToCheckFollow(Creature* creature);
+
+		void addPartyStatusUpdate(Party* party) {
+			partyStatusUpdates.insert(party);
+		}
+		void removePartyStatusUpdate(Party* party) {
+			partyStatusUpdates.erase(party);
+		}
 		
 		std::unordered_set<Tile*> getTilesToClean() const {
 			return tilesToClean;
@@ -717,8 +727,8 @@ class Game
 
 		WildcardTreeNode wildcardTree { false };
 
-		std::map<uint32_t, Npc*> npcs;
-		std::map<uint32_t, Monster*> monsters;
+		CreatureSlotMap<Npc> npcs { 0x80000000 };
+		CreatureSlotMap<Monster> monsters { 0x40000000 };
 
 		std::unordered_map<uint32_t, Monster*> fiendishMonsters;
 
@@ -730,6 +740,7 @@ class Game
 		std::map<uint32_t, BedItem*> bedSleepersMap;
 
 		std::unordered_set<Tile*> tilesToClean;
+		std::unordered_set<Party*> partyStatusUpdates;
 
 		ModalWindow offlineTrainingWindow { std::numeric_limits<uint32_t>::max(), "Choose a Skill", "Please choose a skill:" };
 
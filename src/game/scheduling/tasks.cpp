@@ -48,9 +48,8 @@ void Dispatcher::threadMain()
 {
 	// NOTE: second argument defer_lock is to prevent from immediate locking
 	std::unique_lock<std::mutex> taskLockUnique(taskLock, std::defer_lock);
-#ifdef STATS_ENABLED
 	std::chrono::high_resolution_clock::time_point time_point;
-#endif
+	Tracer& tracer = Tracer::getInstance();
 
 	while (getState() != THREAD_STATE_TERMINATED) {
 		// check if there are tasks waiting
@@ -68,21 +67,27 @@ void Dispatcher::threadMain()
 		}
 
 		if (!taskList.empty()) {
-#ifdef STATS_ENABLED
 			time_point = std::chrono::high_resolution_clock::now();
-#endif
 			// take the first task
 			Task* task = taskList.front();
 			taskList.pop_front();
+			g_metrics.setDispatcherQueue(dispatcherId, taskList.size());
 			taskLockUnique.unlock();
 
+			size_t traceMark = tracer.getHead();
 			if (!task->hasExpired()) {
 				++dispatcherCycle;
 				// execute it
+				TraceSpan span(task->description.empty() ? "task" : task->description.c_str());
 				(*task)();
 			}
-#ifdef STATS_ENABLED
 			task->executionTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - time_point).count();
+			if (task->executionTime > Stats::VERY_SLOW_EXECUTION_TIME) {
+				g_stats.addSlowTrace(tracer.dump(traceMark));
+			}
+			g_metrics.record(METRIC_DISPATCHER_TICK, task->executionTime);
+			g_metrics.recordTask(task->description, task->executionTime);
+#ifdef STATS_ENABLED
 			g_stats.addDispatcherTask(dispatcherId, task);
 #else
 			delete task;
@@ -107,6 +112,7 @@ void Dispatcher::addTask(Task* task, bool push_front /*= false*/)
 		} else {
 			taskList.push_back(task);
 		}
+		g_metrics.setDispatcherQueue(dispatcherId, taskList.size());
 	} else {
 		delete task;
 	}
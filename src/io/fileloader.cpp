@@ -52,27 +52,64 @@ static Node& getCurrentNode(const NodeStack& nodeStack) {
 	return *nodeStack.top();
 }
 
-const Node& Loader::parseTree()
+// Advances from the first child of a node to the END marker of that node
+static ContentIt skipChildren(ContentIt it, ContentIt end)
 {
-	auto it = fileContents.begin() + sizeof(Identifier);
-	if (static_cast<uint8_t>(*it) != Node::START) {
-		throw InvalidOTBFormat{};
+	size_t depth = 0;
+	for (; it != end; ++it) {
+		switch(static_cast<uint8_t>(*it)) {
+			case Node::START: {
+				if (++it == end) {
+					throw InvalidOTBFormat{};
+				}
+				++depth;
+				break;
+			}
+			case Node::END: {
+				if (depth == 0) {
+					return it;
+				}
+				--depth;
+				break;
+			}
+			case Node::ESCAPE: {
+				if (++it == end) {
+					throw InvalidOTBFormat{};
+				}
+				break;
+			}
+			default: {
+				break;
+			}
+		}
 	}
-	root.type = *(++it);
-	root.propsBegin = ++it;
+	throw InvalidOTBFormat{};
+}
+
+// Parses the children of node starting at it, until the END marker of node
+static void parseNode(Node& node, ContentIt it, ContentIt end, size_t maxDepth)
+{
 	NodeStack parseStack;
-	parseStack.push(&root);
+	parseStack.push(&node);
 
-	for (; it != fileContents.end(); ++it) {
+	for (; it != end; ++it) {
 		switch(static_cast<uint8_t>(*it)) {
 			case Node::START: {
 				auto& currentNode = getCurrentNode(parseStack);
 				if (currentNode.children.empty()) {
 					currentNode.propsEnd = it;
 				}
+				if (parseStack.size() > maxDepth) {
+					it = skipChildren(it, end);
+					parseStack.pop();
+					if (parseStack.empty()) {
+						return;
+					}
+					break;
+				}
 				currentNode.children.emplace_back();
 				auto& child = currentNode.children.back();
-				if (++it == fileContents.end()) {
+				if (++it == end) {
 					throw InvalidOTBFormat{};
 				}
 				child.type = *it;
@@ -86,10 +123,13 @@ const Node& Loader::parseTree()
 					currentNode.propsEnd = it;
 				}
 				parseStack.pop();
+				if (parseStack.empty()) {
+					return;
+				}
 				break;
 			}
 			case Node::ESCAPE: {
-				if (++it == fileContents.end()) {
+				if (++it == end) {
 					throw InvalidOTBFormat{};
 				}
 				break;
@@ -99,19 +139,47 @@ const Node& Loader::parseTree()
 			}
 		}
 	}
-	if (!parseStack.empty()) {
+	throw InvalidOTBFormat{};
+}
+
+const Node& Loader::parseTree(size_t maxDepth /* = std::numeric_limits<size_t>::max()*/)
+{
+	auto it = fileContents.begin() + sizeof(Identifier);
+	if (static_cast<uint8_t>(*it) != Node::START) {
 		throw InvalidOTBFormat{};
 	}
-
+	root.type = *(++it);
+	root.propsBegin = ++it;
+	parseNode(root, it, fileContents.end(), maxDepth);
 	return root;
 }
 
-bool Loader::getProps(const Node& node, PropStream& props)
+Node Loader::parseChildren(const Node& node) const
+{
+	Node subtree;
+	subtree.type = node.type;
+	subtree.propsBegin = node.propsBegin;
+	subtree.propsEnd = node.propsEnd;
+	if (static_cast<uint8_t>(*node.propsEnd) == Node::START) {
+		parseNode(subtree, node.propsEnd, fileContents.end(), std::numeric_limits<size_t>::max());
+	}
+	return subtree;
+}
+
+bool Loader::getProps(const Node& node, PropStream& props) const
 {
 	auto size = std::distance(node.propsBegin, node.propsEnd);
 	if (size == 0) {
 		return false;
 	}
+
+	// most nodes hold no escaped bytes and can be read straight from the mapped file
+	if (std::find(node.propsBegin, node.propsEnd, static_cast<char>(Node::ESCAPE)) == node.propsEnd) {
+		props.init(&*node.propsBegin, size);
+		return true;
+	}
+
+	thread_local std::vector<char> propBuffer;
 	propBuffer.resize(size);
 	bool lastEscaped = false;
 
@@ -66,11 +66,22 @@ struct InvalidOTBFormat final : LoadError {
 class Loader {
 	MappedFile fileContents;
 	Node root;
-	std::vector<char> propBuffer;
 public:
 	Loader(const std::string& fileName, const Identifier& acceptedIdentifier);
-	bool getProps(const Node& node, PropStream& props);
-	const Node& parseTree();
+	bool getProps(const Node& node, PropStream& props) const;
+
+	/**
+	 * Parses the node tree up to maxDepth levels below the root. Children of
+	 * nodes at maxDepth are skipped and can be materialized later, one subtree
+	 * at a time, through parseChildren.
+	 */
+	const Node& parseTree(size_t maxDepth = std::numeric_limits<size_t>::max());
+
+	/**
+	 * Returns a copy of a node left unexpanded by parseTree with its whole
+	 * subtree parsed. Safe to call concurrently for different nodes.
+	 */
+	Node parseChildren(const Node& node) const;
 };
 
 } //namespace OTB
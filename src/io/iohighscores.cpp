@@ -0,0 +1,258 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include "io/iohighscores.h"
+
+#include "creatures/players/account/account.hpp"
+#include "creatures/players/vocations/vocation.h"
+#include "database/database.h"
+#include "game/game.h"
+#include "game/scheduling/tasks.h"
+
+extern Game g_game;
+extern Vocations g_vocations;
+
+bool IOHighscores::loadCharacters(CharacterMap& characters)
+{
+	std::ostringstream query;
+	query << "SELECT `id`, `name`, `level`, `vocation`, `experience`, `skill_fist`, `skill_club`, `skill_sword`, `skill_axe`, `skill_dist`, `skill_shielding`, `skill_fishing`, `maglevel` FROM `players` WHERE `group_id` < " << static_cast<int>(account::GroupType::GROUP_TYPE_GAMEMASTER);
+	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	if (!result) {
+		return false;
+	}
+
+	static const std::string columns[CATEGORY_COUNT] = {"experience", "skill_fist", "skill_club", "skill_sword", "skill_axe", "skill_dist", "skill_shielding", "skill_fishing", "maglevel"};
+	do {
+		Character& character = characters[result->getNumber<uint32_t>("id")];
+		character.name = result->getString("name");
+		character.level = result->getNumber<uint16_t>("level");
+		character.vocation = result->getNumber<uint16_t>("vocation");
+		for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+			character.points[i] = result->getNumber<uint64_t>(columns[i]);
+		}
+	} while (result->next());
+	return true;
+}
+
+IOHighscores::BaseVocations IOHighscores::getBaseVocations()
+{
+	BaseVocations baseVocations;
+	for (const auto& it : g_vocations.getVocations()) {
+		baseVocations.emplace(it.first, it.second.getFromVocation());
+	}
+	return baseVocations;
+}
+
+std::shared_ptr<const IOHighscores::Snapshot> IOHighscores::buildSnapshot(CharacterMap characters, const BaseVocations& baseVocations)
+{
+	auto snapshot = std::make_shared<Snapshot>();
+	for (size_t category = 0; category < CATEGORY_COUNT; ++category) {
+		Ranking& ranking = snapshot->rankings[category];
+		RankList& all = ranking.all;
+		all.reserve(characters.size());
+		for (const auto& it : characters) {
+			all.push_back({it.second.points[category], it.first, 0});
+		}
+
+		std::sort(all.begin(), all.end(), [](const RankEntry& lhs, const RankEntry& rhs) {
+			if (lhs.points != rhs.points) {
+				return lhs.points > rhs.points;
+			}
+			return lhs.guid < rhs.guid;
+		});
+
+		// dense ranking, characters with equal points share a rank
+		uint32_t rank = 0;
+		for (size_t i = 0, size = all.size(); i < size; ++i) {
+			RankEntry& entry = all[i];
+			if (i == 0 || entry.points != all[i - 1].points) {
+				++rank;
+			}
+			entry.rank = rank;
+
+			auto vocation = baseVocations.find(characters.at(entry.guid).vocation);
+			if (vocation != baseVocations.end()) {
+				ranking.byVocation[vocation->second].push_back(entry);
+			}
+		}
+	}
+	snapshot->characters = std::move(characters);
+	return snapshot;
+}
+
+void IOHighscores::load()
+{
+	CharacterMap characters;
+	loadCharacters(characters);
+	SPDLOG_INFO("Loaded {} characters into the highscores", characters.size());
+
+	changes.clear();
+	snapshot = buildSnapshot(std::move(characters), getBaseVocations());
+	builtAt = reconciledAt = OTSYS_TIME();
+}
+
+void IOHighscores::updatePlayer(const Player* player)
+{
+	Character& character = changes[player->getGUID()];
+	if (player->getGroup()->id >= account::GROUP_TYPE_GAMEMASTER) {
+		character.removed = true;
+		return;
+	}
+
+	character.removed = false;
+	character.name = player->getName();
+	character.level = static_cast<uint16_t>(player->getLevel());
+	character.vocation = player->getVocationId();
+	character.points[HIGHSCORE_CATEGORY_EXPERIENCE] = player->getExperience();
+	character.points[HIGHSCORE_CATEGORY_FIST_FIGHTING] = player->getBaseSkill(SKILL_FIST);
+	character.points[HIGHSCORE_CATEGORY_CLUB_FIGHTING] = player->getBaseSkill(SKILL_CLUB);
+	character.points[HIGHSCORE_CATEGORY_SWORD_FIGHTING] = player->getBaseSkill(SKILL_SWORD);
+	character.points[HIGHSCORE_CATEGORY_AXE_FIGHTING] = player->getBaseSkill(SKILL_AXE);
+	character.points[HIGHSCORE_CATEGORY_DISTANCE_FIGHTING] = player->getBaseSkill(SKILL_DISTANCE);
+	character.points[HIGHSCORE_CATEGORY_SHIELDING] = player->getBaseSkill(SKILL_SHIELD);
+	character.points[HIGHSCORE_CATEGORY_FISHING] = player->getBaseSkill(SKILL_FISHING);
+	character.points[HIGHSCORE_CATEGORY_MAGIC_LEVEL] = player->getBaseMagicLevel();
+}
+
+void IOHighscores::requestRebuild()
+{
+	// online characters may have advanced since they were last saved
+	for (const auto& it : g_game.getPlayers()) {
+		updatePlayer(it.second);
+	}
+
+	rebuilding = true;
+	const int64_t now = OTSYS_TIME();
+	const bool reconcile = now - reconciledAt >= RECONCILE_INTERVAL;
+	std::thread([previous = snapshot, pending = std::move(changes), baseVocations = getBaseVocations(), reconcile]() {
+		CharacterMap characters;
+		bool reconciled = reconcile && loadCharacters(characters);
+		if (!reconciled) {
+			characters = previous->characters;
+		}
+
+		for (const auto& it : pending) {
+			if (it.second.removed) {
+				characters.erase(it.first);
+			} else {
+				characters[it.first] = it.second;
+			}
+		}
+
+		std::shared_ptr<const Snapshot> built = buildSnapshot(std::move(characters), baseVocations);
+		auto swapSnapshot = [built, reconciled]() {
+			IOHighscores& highscores = IOHighscores::getInstance();
+			highscores.snapshot = built;
+			highscores.builtAt = OTSYS_TIME();
+			if (reconciled) {
+				highscores.reconciledAt = highscores.builtAt;
+			}
+			highscores.rebuilding = false;
+		};
+		g_dispatcher.addTask(createTask(swapSnapshot));
+	}).detach();
+	changes.clear();
+}
+
+const IOHighscores::RankList* IOHighscores::getRankList(uint8_t category, uint32_t vocation)
+{
+	if (category >= CATEGORY_COUNT || !snapshot) {
+		return nullptr;
+	}
+
+	// this request is served from the current rankings, the next one sees the rebuilt ones
+	if (!rebuilding && OTSYS_TIME() - builtAt >= REBUILD_INTERVAL) {
+		requestRebuild();
+	}
+
+	const Ranking& ranking = snapshot->rankings[category];
+	if (vocation == 0xFFFFFFFF) {
+		return &ranking.all;
+	}
+
+	auto it = ranking.byVocation.find(vocation);
+	if (it == ranking.byVocation.end()) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+bool IOHighscores::getEntries(uint8_t category, uint32_t vocation, uint16_t page, uint8_t entriesPerPage, std::vector<HighscoreCharacter>& entries, uint16_t& pages)
+{
+	const RankList* list = getRankList(category, vocation);
+	if (!list || page == 0 || entriesPerPage == 0) {
+		return false;
+	}
+
+	size_t first = static_cast<size_t>(page - 1) * entriesPerPage;
+	if (first >= list->size()) {
+		return false;
+	}
+
+	size_t last = std::min<size_t>(first + entriesPerPage, list->size());
+	entries.reserve(last - first);
+	for (size_t i = first; i < last; ++i) {
+		const RankEntry& entry = (*list)[i];
+		auto it = snapshot->characters.find(entry.guid);
+		if (it == snapshot->characters.end()) {
+			continue;
+		}
+
+		const Character& character = it->second;
+
+		uint8_t clientVocation = 0;
+		if (Vocation* voc = g_vocations.getVocation(character.vocation)) {
+			clientVocation = voc->getClientId();
+		}
+		entries.emplace_back(character.name, entry.points, entry.guid, entry.rank, character.level, clientVocation);
+	}
+
+	pages = static_cast<uint16_t>((list->size() + entriesPerPage - 1) / entriesPerPage);
+	return true;
+}
+
+uint16_t IOHighscores::getPlayerPage(uint8_t category, uint32_t vocation, uint32_t guid, uint8_t entriesPerPage)
+{
+	const RankList* list = getRankList(category, vocation);
+	if (!list || entriesPerPage == 0) {
+		return 1;
+	}
+
+	auto it = snapshot->characters.find(guid);
+	if (it == snapshot->characters.end()) {
+		return 1;
+	}
+
+	// the list is ordered by points, then guid
+	const uint64_t points = it->second.points[category];
+	auto position = std::lower_bound(list->begin(), list->end(), guid, [points](const RankEntry& entry, uint32_t value) {
+		if (entry.points != points) {
+			return entry.points > points;
+		}
+		return entry.guid < value;
+	});
+
+	if (position == list->end() || position->guid != guid) {
+		// joined after the last rebuild
+		return 1;
+	}
+	return static_cast<uint16_t>(std::distance(list->begin(), position) / entriesPerPage + 1);
+}
@@ -0,0 +1,108 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_IOHIGHSCORES_H_7C1E3A9B5D2F4E6A8B0C1D2E3F4A5B6C
+#define FS_IOHIGHSCORES_H_7C1E3A9B5D2F4E6A8B0C1D2E3F4A5B6C
+
+#include <array>
+
+#include "utils/enums.h"
+
+class Player;
+
+/**
+ * In-memory highscore ranking. Seeded from the players table at startup and
+ * kept current from saved and online characters, so browsing the highscores
+ * never touches the database. Rankings are rebuilt on a worker thread and
+ * swapped in whole; the dispatcher only ever reads a finished snapshot.
+ */
+class IOHighscores
+{
+	public:
+		static IOHighscores& getInstance() {
+			static IOHighscores instance;
+			return instance;
+		}
+
+		void load();
+		void updatePlayer(const Player* player);
+
+		bool getEntries(uint8_t category, uint32_t vocation, uint16_t page, uint8_t entriesPerPage, std::vector<HighscoreCharacter>& entries, uint16_t& pages);
+		// page holding the character, the first page when it is not ranked
+		uint16_t getPlayerPage(uint8_t category, uint32_t vocation, uint32_t guid, uint8_t entriesPerPage);
+
+	private:
+		IOHighscores() = default;
+
+		static constexpr size_t CATEGORY_COUNT = HIGHSCORE_CATEGORY_MAGIC_LEVEL + 1;
+		// rankings older than this are rebuilt in the background after the next request
+		static constexpr int64_t REBUILD_INTERVAL = 60 * 1000;
+		// every so often a rebuild reloads the players table, picking up characters
+		// created, renamed or deleted outside the game
+		static constexpr int64_t RECONCILE_INTERVAL = 10 * 60 * 1000;
+
+		struct Character {
+			std::string name;
+			std::array<uint64_t, CATEGORY_COUNT> points;
+			uint16_t level;
+			uint16_t vocation;
+			// pending change only: drop the character from the rankings
+			bool removed = false;
+		};
+
+		using CharacterMap = std::unordered_map<uint32_t, Character>;
+
+		struct RankEntry {
+			uint64_t points;
+			uint32_t guid;
+			uint32_t rank;
+		};
+
+		using RankList = std::vector<RankEntry>;
+
+		struct Ranking {
+			RankList all;
+			// keyed by base vocation, ranks are the ones from all
+			std::map<uint32_t, RankList> byVocation;
+		};
+
+		struct Snapshot {
+			CharacterMap characters;
+			std::array<Ranking, CATEGORY_COUNT> rankings;
+		};
+
+		// vocation id to base vocation, resolved on the dispatcher for the worker
+		using BaseVocations = std::map<uint16_t, uint32_t>;
+
+		static bool loadCharacters(CharacterMap& characters);
+		static std::shared_ptr<const Snapshot> buildSnapshot(CharacterMap characters, const BaseVocations& baseVocations);
+		static BaseVocations getBaseVocations();
+
+		const RankList* getRankList(uint8_t category, uint32_t vocation);
+		void requestRebuild();
+
+		std::shared_ptr<const Snapshot> snapshot;
+		// characters saved or online since the last rebuild started, applied over the next one
+		CharacterMap changes;
+		int64_t builtAt = 0;
+		int64_t reconciledAt = 0;
+		bool rebuilding = false;
+};
+
+#endif
@@ -21,6 +21,7 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 #include "io/iologindata.h"
+#include "io/iohighscores.h"
 #include "config/configmanager.h"
 #include "game/game.h"
 #include "game/scheduling/scheduler.h"
@@ -1342,7 +1343,12 @@ bool IOLoginData::savePlayer(Player* player)
   }
 
     //End the transaction
-  return transaction.commit();
+  if (!transaction.commit()) {
+    return false;
+  }
+
+  IOHighscores::getInstance().updatePlayer(player);
+  return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid)
@@ -19,10 +19,16 @@
 
 #include "otpch.h"
 
+#include <atomic>
+
 #include "io/iomap.h"
 
 #include "items/bed.h"
+#include "game/game.h"
 #include "game/movement/teleport.h"
+#include "game/scheduling/tasks.h"
+
+extern Game g_game;
 
 /*
 	OTBM_ROOTV1
@@ -54,70 +60,54 @@ Tile* IOMap::createTile(Item*& ground, Item* item, uint16_t x, uint16_t y, uint8
 		return new StaticTile(x, y, z);
 	}
 
+	// most of the map is bare ground nobody ever drops anything on, so those
+	// tiles only grow their item and creature lists when actually needed
 	Tile* tile;
-	if ((item && item->isBlocking()) || ground->isBlocking()) {
+	if (!item || item->isBlocking() || ground->isBlocking()) {
 		tile = new StaticTile(x, y, z);
 	} else {
 		tile = new DynamicTile(x, y, z);
 	}
 
 	tile->internalAddThing(ground);
+	registerItem(ground);
 	ground->startDecaying();
 	ground = nullptr;
 	return tile;
 }
 
-bool IOMap::loadMap(Map* map, const std::string& fileName)
+void IOMap::registerItem(Item* item)
 {
-	int64_t start = OTSYS_TIME();
-	OTB::Loader loader{fileName, OTB::Identifier{{'O', 'T', 'B', 'M'}}};
-	auto& root = loader.parseTree();
-
-	PropStream propStream;
-	if (!loader.getProps(root, propStream)) {
-		setLastErrorString("Could not read root property.");
-		return false;
-	}
-
-	OTBM_root_header root_header;
-	if (!propStream.read(root_header)) {
-		setLastErrorString("Could not read header.");
-		return false;
+	uint16_t uniqueId = item->getUniqueId();
+	if (uniqueId != 0 && !g_game.addUniqueItem(uniqueId, item)) {
+		item->removeAttribute(ITEM_ATTRIBUTE_UNIQUEID);
 	}
 
-	uint32_t headerVersion = root_header.version;
-	if (headerVersion <= 0) {
-		//In otbm version 1 the count variable after splashes/fluidcontainers and stackables
-		//are saved as attributes instead, this solves alot of problems with items
-		//that is changed (stackable/charges/fluidcontainer/splash) during an update.
-		setLastErrorString("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
-		return false;
+	BedItem* bed = item->getBed();
+	if (bed && bed->getSleeper() != 0) {
+		bed->registerSleeper();
 	}
 
-	if (headerVersion > 2) {
-		setLastErrorString("Unknown OTBM version detected.");
-		return false;
+	if (Container* container = item->getContainer()) {
+		for (Item* containerItem : container->getItemList()) {
+			registerItem(containerItem);
+		}
 	}
+}
 
-	if (root_header.majorVersionItems < 3) {
-		setLastErrorString("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
-		return false;
-	}
+bool IOMap::loadMap(Map* map, const std::string& fileName)
+{
+	int64_t start = OTSYS_TIME();
+	OTB::Loader loader{fileName, OTB::Identifier{{'O', 'T', 'B', 'M'}}};
 
-	if (root_header.majorVersionItems > Item::items.majorVersion) {
-		setLastErrorString("The map was saved with a different items.otb version, an upgraded items.otb is required.");
-		return false;
-	}
+	// root -> map data -> tile areas, the tiles of each area are parsed by the thread loading it
+	auto& root = loader.parseTree(2);
 
-	if (root_header.minorVersionItems < CLIENT_VERSION_810) {
-		setLastErrorString("This map needs to be updated.");
+	OTBM_root_header root_header;
+	if (!parseRootHeader(loader, root, root_header)) {
 		return false;
 	}
 
-	if (root_header.minorVersionItems > Item::items.minorVersion) {
-		SPDLOG_WARN("[IOMap::loadMap] This map needs an updated items.otb");
-	}
-
 	SPDLOG_INFO("Map size: {}x{}", root_header.width, root_header.height);
 	map->width = root_header.width;
 	map->height = root_header.height;
@@ -132,17 +122,17 @@ bool IOMap::loadMap(Map* map, const std::string& fileName)
 		return false;
 	}
 
+	std::vector<TileArea> tileAreas;
 	for (auto& mapDataNode : mapNode.children) {
 		if (mapDataNode.type == OTBM_TILE_AREA) {
-			if (!parseTileArea(loader, mapDataNode, *map)) {
-				return false;
-			}
+			tileAreas.emplace_back();
+			tileAreas.back().node = &mapDataNode;
 		} else if (mapDataNode.type == OTBM_TOWNS) {
-			if (!parseTowns(loader, mapDataNode, *map)) {
+			if (!parseTowns(loader, loader.parseChildren(mapDataNode), *map)) {
 				return false;
 			}
-		} else if (mapDataNode.type == OTBM_WAYPOINTS && headerVersion > 1) {
-			if (!parseWaypoints(loader, mapDataNode, *map)) {
+		} else if (mapDataNode.type == OTBM_WAYPOINTS && root_header.version > 1) {
+			if (!parseWaypoints(loader, loader.parseChildren(mapDataNode), *map)) {
 				return false;
 			}
 		} else {
@@ -151,10 +141,61 @@ bool IOMap::loadMap(Map* map, const std::string& fileName)
 		}
 	}
 
+	if (!loadTileAreas(loader, tileAreas, *map)) {
+		return false;
+	}
+
 	SPDLOG_INFO("Map loading time: {} seconds", (OTSYS_TIME() - start) / (1000.));
 	return true;
 }
 
+bool IOMap::parseRootHeader(OTB::Loader& loader, const OTB::Node& root, OTBM_root_header& rootHeader)
+{
+	PropStream propStream;
+	if (!loader.getProps(root, propStream)) {
+		setLastErrorString("Could not read root property.");
+		return false;
+	}
+
+	if (!propStream.read(rootHeader)) {
+		setLastErrorString("Could not read header.");
+		return false;
+	}
+
+	if (rootHeader.version <= 0) {
+		//In otbm version 1 the count variable after splashes/fluidcontainers and stackables
+		//are saved as attributes instead, this solves alot of problems with items
+		//that is changed (stackable/charges/fluidcontainer/splash) during an update.
+		setLastErrorString("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
+		return false;
+	}
+
+	if (rootHeader.version > 2) {
+		setLastErrorString("Unknown OTBM version detected.");
+		return false;
+	}
+
+	if (rootHeader.majorVersionItems < 3) {
+		setLastErrorString("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
+		return false;
+	}
+
+	if (rootHeader.majorVersionItems > Item::items.majorVersion) {
+		setLastErrorString("The map was saved with a different items.otb version, an upgraded items.otb is required.");
+		return false;
+	}
+
+	if (rootHeader.minorVersionItems < CLIENT_VERSION_810) {
+		setLastErrorString("This map needs to be updated.");
+		return false;
+	}
+
+	if (rootHeader.minorVersionItems > Item::items.minorVersion) {
+		SPDLOG_WARN("[IOMap::loadMap] This map needs an updated items.otb");
+	}
+	return true;
+}
+
 bool IOMap::parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode, Map& map, const std::string& fileName)
 {
 	PropStream propStream;
@@ -204,72 +245,123 @@ bool IOMap::parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode
 	return true;
 }
 
-bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Map& map)
+bool IOMap::loadTileAreas(OTB::Loader& loader, std::vector<TileArea>& tileAreas, Map& map)
+{
+	int64_t start = OTSYS_TIME();
+
+	size_t threadCount = std::max<int32_t>(g_config.getNumber(ConfigManager::MAP_LOAD_THREADS), 0);
+	if (threadCount == 0) {
+		threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+	threadCount = std::max<size_t>(std::min(threadCount, tileAreas.size()), 1);
+
+	// Items and tiles are built in parallel, anything touching shared state
+	// (houses, unique ids, bed sleepers, decay, the map itself) is deferred to placeTileArea
+	std::atomic<size_t> nextArea{0};
+	auto readAreas = [&loader, &tileAreas, &nextArea]() {
+		size_t index;
+		while ((index = nextArea.fetch_add(1, std::memory_order_relaxed)) < tileAreas.size()) {
+			readTileArea(loader, tileAreas[index]);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	for (size_t i = 1; i < threadCount; ++i) {
+		threads.emplace_back(readAreas);
+	}
+	readAreas();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	for (TileArea& tileArea : tileAreas) {
+		if (!tileArea.error.empty()) {
+			setLastErrorString(std::move(tileArea.error));
+			return false;
+		}
+
+		if (!placeTileArea(tileArea, map)) {
+			return false;
+		}
+		std::vector<LoadedTile>().swap(tileArea.tiles);
+	}
+
+	SPDLOG_INFO("Loaded {} tile areas in {} seconds using {} threads",
+                tileAreas.size(), (OTSYS_TIME() - start) / (1000.), threadCount);
+	return true;
+}
+
+bool IOMap::readTileArea(OTB::Loader& loader, TileArea& tileArea)
+{
+	// g_game is only touched by the thread placing the tiles
+	Item::deferRegistration = true;
+	bool result = readTiles(loader, tileArea);
+	Item::deferRegistration = false;
+	return result;
+}
+
+bool IOMap::readTiles(OTB::Loader& loader, TileArea& tileArea)
 {
 	PropStream propStream;
-	if (!loader.getProps(tileAreaNode, propStream)) {
-		setLastErrorString("Invalid map node.");
+	if (!loader.getProps(*tileArea.node, propStream)) {
+		tileArea.error = "Invalid map node.";
 		return false;
 	}
 
 	OTBM_Destination_coords area_coord;
 	if (!propStream.read(area_coord)) {
-		setLastErrorString("Invalid map node.");
+		tileArea.error = "Invalid map node.";
 		return false;
 	}
 
 	uint16_t base_x = area_coord.x;
 	uint16_t base_y = area_coord.y;
 	uint16_t z = area_coord.z;
+	tileArea.z = area_coord.z;
 
-	static std::map<uint64_t, uint64_t> teleportMap;
+	OTB::Node tileAreaNode;
+	try {
+		tileAreaNode = loader.parseChildren(*tileArea.node);
+	} catch (const OTB::LoadError& err) {
+		tileArea.error = err.what();
+		return false;
+	}
 
+	tileArea.tiles.reserve(tileAreaNode.children.size());
 	for (auto& tileNode : tileAreaNode.children) {
 		if (tileNode.type != OTBM_TILE && tileNode.type != OTBM_HOUSETILE) {
-			setLastErrorString("Unknown tile node.");
+			tileArea.error = "Unknown tile node.";
 			return false;
 		}
 
 		if (!loader.getProps(tileNode, propStream)) {
-			setLastErrorString("Could not read node data.");
+			tileArea.error = "Could not read node data.";
 			return false;
 		}
 
 		OTBM_Tile_coords tile_coord;
 		if (!propStream.read(tile_coord)) {
-			setLastErrorString("Could not read tile position.");
+			tileArea.error = "Could not read tile position.";
 			return false;
 		}
 
 		uint16_t x = base_x + tile_coord.x;
 		uint16_t y = base_y + tile_coord.y;
 
-		bool isHouseTile = false;
-		House* house = nullptr;
-		Tile* tile = nullptr;
-		Item* ground_item = nullptr;
-		uint32_t tileflags = TILESTATE_NONE;
+		tileArea.tiles.emplace_back();
+		LoadedTile& tile = tileArea.tiles.back();
+		tile.x = x;
+		tile.y = y;
 
 		if (tileNode.type == OTBM_HOUSETILE) {
-			uint32_t houseId;
-			if (!propStream.read<uint32_t>(houseId)) {
+			if (!propStream.read<uint32_t>(tile.houseId)) {
 				std::ostringstream ss;
 				ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Could not read house id.";
-				setLastErrorString(ss.str());
+				tileArea.error = ss.str();
 				return false;
 			}
-
-			house = map.houses.addHouse(houseId);
-			if (!house) {
-				std::ostringstream ss;
-				ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Could not create house id: " << houseId;
-				setLastErrorString(ss.str());
-				return false;
-			}
-
-			tile = new HouseTile(x, y, z, house);
-			house->addTile(static_cast<HouseTile*>(tile));
-			isHouseTile = true;
+			tile.isHouseTile = true;
 		}
 
 		uint8_t attribute;
@@ -281,20 +373,20 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 					if (!propStream.read<uint32_t>(flags)) {
 						std::ostringstream ss;
 						ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Failed to read tile flags.";
-						setLastErrorString(ss.str());
+						tileArea.error = ss.str();
 						return false;
 					}
 
 					if ((flags & OTBM_TILEFLAG_PROTECTIONZONE) != 0) {
-						tileflags |= TILESTATE_PROTECTIONZONE;
+						tile.flags |= TILESTATE_PROTECTIONZONE;
 					} else if ((flags & OTBM_TILEFLAG_NOPVPZONE) != 0) {
-						tileflags |= TILESTATE_NOPVPZONE;
+						tile.flags |= TILESTATE_NOPVPZONE;
 					} else if ((flags & OTBM_TILEFLAG_PVPZONE) != 0) {
-						tileflags |= TILESTATE_PVPZONE;
+						tile.flags |= TILESTATE_PVPZONE;
 					}
 
 					if ((flags & OTBM_TILEFLAG_NOLOGOUT) != 0) {
-						tileflags |= TILESTATE_NOLOGOUT;
+						tile.flags |= TILESTATE_NOLOGOUT;
 					}
 					break;
 				}
@@ -304,67 +396,19 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 					if (!item) {
 						std::ostringstream ss;
 						ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Failed to create item.";
-						setLastErrorString(ss.str());
+						tileArea.error = ss.str();
 						return false;
 					}
 
-			if (Teleport* teleport = item->getTeleport()) {
-				const Position& destPos = teleport->getDestPos();
-				uint64_t teleportPosition = (static_cast<uint64_t>(x) << 24) | (y << 8) | z;
-				uint64_t destinationPosition = (static_cast<uint64_t>(destPos.x) << 24) | (destPos.y << 8) | destPos.z;
-				teleportMap.emplace(teleportPosition, destinationPosition);
-				auto it = teleportMap.find(destinationPosition);
-				if (it != teleportMap.end()) {
-					SPDLOG_WARN("[IOMap::loadMap] - "
-                                "Teleport in position: x {}, y {}, z {} "
-                                "is leading to another teleport", x, y, z);
-				}
-				for (auto const& it2 : teleportMap) {
-					if (it2.second == teleportPosition) {
-						uint16_t fx = (it2.first >> 24) & 0xFFFF;
-						uint16_t fy = (it2.first >> 8) & 0xFFFF;
-						uint8_t fz = (it2.first) & 0xFF;
-						SPDLOG_WARN("[IOMap::loadMap] - "
-                                    "Teleport in position: x {}, y {}, z {} "
-                                    "is leading to another teleport",
-                                    fx, fy, static_cast<uint16_t>(fz));
-					}
-				}
-
-			}
-
-					if (isHouseTile && item->isMoveable()) {
-						SPDLOG_WARN("[IOMap::loadMap] - "
-                                    "Moveable item with ID: {}, in house: {}, "
-                                    "at position: x {}, y {}, z {}",
-                                    item->getID(), house->getId(), x, y, z);
-						delete item;
-					} else {
-						if (item->getItemCount() <= 0) {
-							item->setItemCount(1);
-						}
-
-						if (tile) {
-							tile->internalAddThing(item);
-							item->startDecaying();
-							item->setLoadedFromMap(true);
-						} else if (item->isGroundTile()) {
-							delete ground_item;
-							ground_item = item;
-						} else {
-							tile = createTile(ground_item, item, x, y, z);
-							tile->internalAddThing(item);
-							item->startDecaying();
-							item->setLoadedFromMap(true);
-						}
-					}
+					tile.items.push_back(item);
+					++tile.inlineItems;
 					break;
 				}
 
 				default:
 					std::ostringstream ss;
 					ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Unknown tile attribute.";
-					setLastErrorString(ss.str());
+					tileArea.error = ss.str();
 					return false;
 			}
 		}
@@ -373,13 +417,13 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 			if (itemNode.type != OTBM_ITEM) {
 				std::ostringstream ss;
 				ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Unknown node type.";
-				setLastErrorString(ss.str());
+				tileArea.error = ss.str();
 				return false;
 			}
 
 			PropStream stream;
 			if (!loader.getProps(itemNode, stream)) {
-				setLastErrorString("Invalid item node.");
+				tileArea.error = "Invalid item node.";
 				return false;
 			}
 
@@ -387,56 +431,341 @@ bool IOMap::parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Ma
 			if (!item) {
 				std::ostringstream ss;
 				ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Failed to create item.";
-				setLastErrorString(ss.str());
+				tileArea.error = ss.str();
 				return false;
 			}
 
 			if (!item->unserializeItemNode(loader, itemNode, stream)) {
 				std::ostringstream ss;
 				ss << "[x:" << x << ", y:" << y << ", z:" << z << "] Failed to load item " << item->getID() << '.';
-				setLastErrorString(ss.str());
+				tileArea.error = ss.str();
 				delete item;
 				return false;
 			}
 
-			if (isHouseTile && item->isMoveable()) {
-				SPDLOG_WARN("[IOMap::loadMap] - "
-                                    "Moveable item with ID: {}, in house: {}, "
-                                    "at position: x {}, y {}, z {}",
-                                    item->getID(), house->getId(), x, y, z);
-				delete item;
-			} else {
-				if (item->getItemCount() <= 0) {
-					item->setItemCount(1);
-				}
+			tile.items.push_back(item);
+		}
+	}
+	return true;
+}
+
+bool IOMap::placeTileArea(TileArea& tileArea, Map& map)
+{
+	for (LoadedTile& loadedTile : tileArea.tiles) {
+		if (!placeTile(loadedTile, tileArea.z, map)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IOMap::placeTile(LoadedTile& loadedTile, uint8_t z, Map& map)
+{
+	static std::map<uint64_t, uint64_t> teleportMap;
+
+	uint16_t x = loadedTile.x;
+	uint16_t y = loadedTile.y;
+	bool isHouseTile = loadedTile.isHouseTile;
+	House* house = nullptr;
+	Tile* tile = nullptr;
+	Item* ground_item = nullptr;
+
+	if (isHouseTile) {
+		house = map.houses.addHouse(loadedTile.houseId);
+		if (!house) {
+			std::ostringstream ss;
+			ss << "[x:" << x << ", y:" << y << ", z:" << static_cast<uint16_t>(z) << "] Could not create house id: " << loadedTile.houseId;
+			setLastErrorString(ss.str());
+			return false;
+		}
 
-				if (tile) {
-					tile->internalAddThing(item);
-					item->startDecaying();
-					item->setLoadedFromMap(true);
-				} else if (item->isGroundTile()) {
-					delete ground_item;
-					ground_item = item;
-				} else {
-					tile = createTile(ground_item, item, x, y, z);
-					tile->internalAddThing(item);
-					item->startDecaying();
-					item->setLoadedFromMap(true);
+		tile = new HouseTile(x, y, z, house);
+		house->addTile(static_cast<HouseTile*>(tile));
+	}
+
+	for (size_t i = 0; i < loadedTile.items.size(); ++i) {
+		Item* item = loadedTile.items[i];
+		if (i < loadedTile.inlineItems) {
+			if (Teleport* teleport = item->getTeleport()) {
+				const Position& destPos = teleport->getDestPos();
+				uint64_t teleportPosition = (static_cast<uint64_t>(x) << 24) | (y << 8) | z;
+				uint64_t destinationPosition = (static_cast<uint64_t>(destPos.x) << 24) | (destPos.y << 8) | destPos.z;
+				teleportMap.emplace(teleportPosition, destinationPosition);
+				auto it = teleportMap.find(destinationPosition);
+				if (it != teleportMap.end()) {
+					SPDLOG_WARN("[IOMap::loadMap] - "
+                                "Teleport in position: x {}, y {}, z {} "
+                                "is leading to another teleport", x, y, z);
+				}
+				for (auto const& it2 : teleportMap) {
+					if (it2.second == teleportPosition) {
+						uint16_t fx = (it2.first >> 24) & 0xFFFF;
+						uint16_t fy = (it2.first >> 8) & 0xFFFF;
+						uint8_t fz = (it2.first) & 0xFF;
+						SPDLOG_WARN("[IOMap::loadMap] - "
+                                    "Teleport in position: x {}, y {}, z {} "
+                                    "is leading to another teleport",
+                                    fx, fy, static_cast<uint16_t>(fz));
+					}
 				}
 			}
 		}
 
-		if (!tile) {
-			tile = createTile(ground_item, nullptr, x, y, z);
+		if (isHouseTile && item->isMoveable()) {
+			SPDLOG_WARN("[IOMap::loadMap] - "
+                        "Moveable item with ID: {}, in house: {}, "
+                        "at position: x {}, y {}, z {}",
+                        item->getID(), house->getId(), x, y, z);
+			delete item;
+		} else {
+			if (item->getItemCount() <= 0) {
+				item->setItemCount(1);
+			}
+
+			if (tile) {
+				tile->internalAddThing(item);
+				registerItem(item);
+				item->startDecaying();
+				item->setLoadedFromMap(true);
+			} else if (item->isGroundTile()) {
+				delete ground_item;
+				ground_item = item;
+			} else {
+				tile = createTile(ground_item, item, x, y, z);
+				tile->internalAddThing(item);
+				registerItem(item);
+				item->startDecaying();
+				item->setLoadedFromMap(true);
+			}
 		}
+	}
 
-		tile->setFlag(static_cast<tileflags_t>(tileflags));
+	if (!tile) {
+		tile = createTile(ground_item, nullptr, x, y, z);
+	}
+
+	tile->setFlag(static_cast<tileflags_t>(loadedTile.flags));
+
+	map.setTile(x, y, z, tile);
+	return true;
+}
 
-		map.setTile(x, y, z, tile);
+void IOMap::freeTileAreas(std::vector<TileArea>& tileAreas)
+{
+	for (TileArea& tileArea : tileAreas) {
+		for (LoadedTile& loadedTile : tileArea.tiles) {
+			for (Item* item : loadedTile.items) {
+				delete item;
+			}
+		}
+		std::vector<LoadedTile>().swap(tileArea.tiles);
+	}
+}
+
+// Map loaded at runtime, parsed off the dispatcher and placed a batch at a time
+struct IOMap::MapPatch
+{
+	MapPatch(const std::string& fileName, std::function<void(bool)> onLoaded) :
+		fileName(fileName), loader{fileName, OTB::Identifier{{'O', 'T', 'B', 'M'}}}, onLoaded(std::move(onLoaded)) {}
+
+	std::string fileName;
+	OTB::Loader loader;
+	std::function<void(bool)> onLoaded;
+	IOMap io;
+
+	OTB::Node towns;
+	OTB::Node waypoints;
+	std::vector<TileArea> tileAreas;
+
+	// next tile to place
+	size_t areaIndex = 0;
+	size_t tileIndex = 0;
+
+	// placed tiles not yet sent to the players around, by 8x8 block of a floor
+	std::map<uint64_t, std::vector<Position>> pendingUpdates;
+
+	size_t placedTiles = 0;
+	int64_t start = OTSYS_TIME();
+};
+
+void IOMap::loadMapPatch(const std::string& fileName, std::function<void(bool)> onLoaded /* = nullptr*/)
+{
+	std::thread([fileName, onLoaded]() {
+		auto notifyFailure = [&onLoaded]() {
+			if (onLoaded) {
+				g_dispatcher.addTask(createTask(std::bind(onLoaded, false)));
+			}
+		};
+
+		std::shared_ptr<MapPatch> patch;
+		try {
+			patch = std::make_shared<MapPatch>(fileName, onLoaded);
+		} catch (const std::exception& e) {
+			SPDLOG_ERROR("[IOMap::loadMapPatch] - Failed to load map {}: {}", fileName, e.what());
+			notifyFailure();
+			return;
+		}
+
+		if (!patch->io.readMapPatch(*patch)) {
+			SPDLOG_ERROR("[IOMap::loadMapPatch] - Failed to load map {}: {}", fileName, patch->io.getLastErrorString());
+			freeTileAreas(patch->tileAreas);
+			notifyFailure();
+			return;
+		}
+
+		SPDLOG_INFO("Map {} parsed in {} seconds", fileName, (OTSYS_TIME() - patch->start) / (1000.));
+		g_dispatcher.addTask(createTask(std::bind(&IOMap::placeMapPatch, patch)));
+	}).detach();
+}
+
+bool IOMap::readMapPatch(MapPatch& patch)
+{
+	OTB::Loader& loader = patch.loader;
+	try {
+		auto& root = loader.parseTree(2);
+
+		OTBM_root_header root_header;
+		if (!parseRootHeader(loader, root, root_header)) {
+			return false;
+		}
+
+		if (root.children.size() != 1 || root.children[0].type != OTBM_MAP_DATA) {
+			setLastErrorString("Could not read data node.");
+			return false;
+		}
+
+		// towns and waypoints are few, they are kept for the dispatcher
+		for (auto& mapDataNode : root.children[0].children) {
+			if (mapDataNode.type == OTBM_TILE_AREA) {
+				patch.tileAreas.emplace_back();
+				patch.tileAreas.back().node = &mapDataNode;
+			} else if (mapDataNode.type == OTBM_TOWNS) {
+				patch.towns = loader.parseChildren(mapDataNode);
+			} else if (mapDataNode.type == OTBM_WAYPOINTS && root_header.version > 1) {
+				patch.waypoints = loader.parseChildren(mapDataNode);
+			} else {
+				setLastErrorString("Unknown map node.");
+				return false;
+			}
+		}
+	} catch (const OTB::LoadError& err) {
+		setLastErrorString(err.what());
+		return false;
+	}
+
+	for (TileArea& tileArea : patch.tileAreas) {
+		if (!readTileArea(loader, tileArea)) {
+			setLastErrorString(std::move(tileArea.error));
+			return false;
+		}
 	}
 	return true;
 }
 
+void IOMap::placeMapPatch(const std::shared_ptr<MapPatch>& patch)
+{
+	// a dispatcher task must stay short, the rest of the patch is left for the next one
+	static constexpr int64_t batchTime = 5;
+
+	Map& map = g_game.map;
+	int64_t deadline = OTSYS_TIME() + batchTime;
+
+	// tiles left unsent by the previous batch go first, sending counts against the budget too
+	bool updated = updatePlacedTiles(map, *patch, deadline);
+	size_t batchTiles = 0;
+	while (updated && patch->areaIndex < patch->tileAreas.size()) {
+		TileArea& tileArea = patch->tileAreas[patch->areaIndex];
+		if (patch->tileIndex == tileArea.tiles.size()) {
+			std::vector<LoadedTile>().swap(tileArea.tiles);
+			++patch->areaIndex;
+			patch->tileIndex = 0;
+			continue;
+		}
+
+		LoadedTile& loadedTile = tileArea.tiles[patch->tileIndex++];
+		if (patch->io.placeTile(loadedTile, tileArea.z, map)) {
+			uint64_t block = (static_cast<uint64_t>(tileArea.z) << 32) | ((loadedTile.y >> 3) << 16) | (loadedTile.x >> 3);
+			patch->pendingUpdates[block].emplace_back(loadedTile.x, loadedTile.y, tileArea.z);
+			++patch->placedTiles;
+		} else {
+			// the world is already partly changed, skip the tile rather than the rest of the map
+			SPDLOG_WARN("[IOMap::placeMapPatch] - {}: {}", patch->fileName, patch->io.getLastErrorString());
+			for (Item* item : loadedTile.items) {
+				delete item;
+			}
+		}
+		loadedTile.items.clear();
+
+		if ((++batchTiles & 63) == 0 && OTSYS_TIME() >= deadline) {
+			break;
+		}
+	}
+
+	if (updated) {
+		updated = updatePlacedTiles(map, *patch, deadline);
+	}
+
+	if (!updated || patch->areaIndex < patch->tileAreas.size()) {
+		g_dispatcher.addTask(createTask(std::bind(&IOMap::placeMapPatch, patch)));
+		return;
+	}
+
+	if (!patch->io.parseTowns(patch->loader, patch->towns, map) || !patch->io.parseWaypoints(patch->loader, patch->waypoints, map)) {
+		SPDLOG_WARN("[IOMap::placeMapPatch] - {}: {}", patch->fileName, patch->io.getLastErrorString());
+	}
+
+	SPDLOG_INFO("Map {} loaded, {} tiles placed in {} seconds",
+                patch->fileName, patch->placedTiles, (OTSYS_TIME() - patch->start) / (1000.));
+
+	if (patch->onLoaded) {
+		patch->onLoaded(true);
+	}
+}
+
+bool IOMap::updatePlacedTiles(Map& map, MapPatch& patch, int64_t deadline)
+{
+	// one spectator lookup per 8x8 block, areas far apart never turn into a
+	// lookup over the whole map between them; the protocol drops the tiles
+	// a player cannot see
+	auto& pendingUpdates = patch.pendingUpdates;
+	while (!pendingUpdates.empty()) {
+		const std::vector<Position>& positions = pendingUpdates.begin()->second;
+
+		uint16_t minX = std::numeric_limits<uint16_t>::max();
+		uint16_t minY = std::numeric_limits<uint16_t>::max();
+		uint16_t maxX = 0;
+		uint16_t maxY = 0;
+		for (const Position& pos : positions) {
+			minX = std::min(minX, pos.x);
+			minY = std::min(minY, pos.y);
+			maxX = std::max(maxX, pos.x);
+			maxY = std::max(maxY, pos.y);
+		}
+
+		int32_t rangeX = (maxX - minX + 1) / 2 + Map::maxViewportX;
+		int32_t rangeY = (maxY - minY + 1) / 2 + Map::maxViewportY;
+		Position centerPos((minX + maxX) / 2, (minY + maxY) / 2, positions.front().z);
+
+		SpectatorHashSet spectators;
+		map.getSpectators(spectators, centerPos, true, true, rangeX, rangeX, rangeY, rangeY);
+		if (!spectators.empty()) {
+			for (const Position& pos : positions) {
+				if (const Tile* tile = map.getTile(pos)) {
+					for (Creature* spectator : spectators) {
+						spectator->getPlayer()->sendUpdateTile(tile, pos);
+					}
+				}
+			}
+		}
+		pendingUpdates.erase(pendingUpdates.begin());
+
+		if (OTSYS_TIME() >= deadline) {
+			break;
+		}
+	}
+	return pendingUpdates.empty();
+}
+
 bool IOMap::parseTowns(OTB::Loader& loader, const OTB::Node& townsNode, Map& map)
 {
 	for (auto& townNode : townsNode.children) {
@@ -111,6 +111,16 @@ class IOMap
 	public:
 		bool loadMap(Map* map, const std::string& identifier);
 
+		/* Load a map on top of the running world (world changes, custom maps)
+		 * The file is parsed and its items built on a background thread, then
+		 * the dispatcher places the tiles in small time-budgeted batches and
+		 * updates them for the players around.
+		 * \param fileName path of the otbm file
+		 * \param onLoaded called on the dispatcher once the last tile is placed,
+		 * or with false when the file could not be loaded
+		 */
+		static void loadMapPatch(const std::string& fileName, std::function<void(bool)> onLoaded = nullptr);
+
 		/* Load the spawns
 		 * \param map pointer to the Map class
 		 * \returns Returns true if the spawns were loaded successfully
@@ -150,10 +160,42 @@ class IOMap
 		}
 
 	private:
+		// Tile decoded by a loader thread, placed on the map by the main thread
+		struct LoadedTile {
+			std::vector<Item*> items;
+			uint32_t houseId = 0;
+			uint32_t flags = TILESTATE_NONE;
+			uint16_t x = 0;
+			uint16_t y = 0;
+			// items stored as tile attributes, they precede the item nodes in items
+			size_t inlineItems = 0;
+			bool isHouseTile = false;
+		};
+
+		struct TileArea {
+			const OTB::Node* node = nullptr;
+			std::vector<LoadedTile> tiles;
+			std::string error;
+			uint8_t z = 0;
+		};
+
+		struct MapPatch;
+
+		bool parseRootHeader(OTB::Loader& loader, const OTB::Node& root, OTBM_root_header& rootHeader);
 		bool parseMapDataAttributes(OTB::Loader& loader, const OTB::Node& mapNode, Map& map, const std::string& fileName);
 		bool parseWaypoints(OTB::Loader& loader, const OTB::Node& waypointsNode, Map& map);
 		bool parseTowns(OTB::Loader& loader, const OTB::Node& townsNode, Map& map);
-		bool parseTileArea(OTB::Loader& loader, const OTB::Node& tileAreaNode, Map& map);
+		bool loadTileAreas(OTB::Loader& loader, std::vector<TileArea>& tileAreas, Map& map);
+		static bool readTileArea(OTB::Loader& loader, TileArea& tileArea);
+		static bool readTiles(OTB::Loader& loader, TileArea& tileArea);
+		static void registerItem(Item* item);
+		bool placeTileArea(TileArea& tileArea, Map& map);
+		bool placeTile(LoadedTile& loadedTile, uint8_t z, Map& map);
+		static void freeTileAreas(std::vector<TileArea>& tileAreas);
+
+		bool readMapPatch(MapPatch& patch);
+		static void placeMapPatch(const std::shared_ptr<MapPatch>& patch);
+		static bool updatePlacedTiles(Map& map, MapPatch& patch, int64_t deadline);
 		std::string errorString;
 };
 
@@ -53,11 +53,9 @@ Attr_ReadValue BedItem::readAttr(AttrTypes_t attr, PropStream& propStream)
 			}
 
 			if (guid != 0) {
-				std::string name = IOLoginData::getNameByGuid(guid);
-				if (!name.empty()) {
-					setSpecialDescription(name + " is sleeping there.");
-					g_game.setBedSleeper(this, guid);
-					sleeperGUID = guid;
+				sleeperGUID = guid;
+				if (!deferRegistration) {
+					registerSleeper();
 				}
 			}
 			return ATTR_READ_CONTINUE;
@@ -79,6 +77,18 @@ Attr_ReadValue BedItem::readAttr(AttrTypes_t attr, PropStream& propStream)
 	return Item::readAttr(attr, propStream);
 }
 
+void BedItem::registerSleeper()
+{
+	std::string name = IOLoginData::getNameByGuid(sleeperGUID);
+	if (name.empty()) {
+		sleeperGUID = 0;
+		return;
+	}
+
+	setSpecialDescription(name + " is sleeping there.");
+	g_game.setBedSleeper(this, sleeperGUID);
+}
+
 void BedItem::serializeAttr(PropWriteStream& propWriteStream) const
 {
 	if (sleeperGUID != 0) {
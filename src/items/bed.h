@@ -52,6 +52,8 @@ class BedItem final : public Item
 		uint32_t getSleeper() const {
 			return sleeperGUID;
 		}
+		// Looks up the sleeper read by readAttr and registers the bed with the game
+		void registerSleeper();
 
 		void setHouse(House* h) {
 			house = h;
@@ -837,10 +837,9 @@ void ContainerIterator::advance()
 
 	++cur;
 
-	if (cur == over.front()->itemlist.end()) {
-		over.pop_front();
-		if (!over.empty()) {
-			cur = over.front()->itemlist.begin();
+	if (cur == over[overIndex]->itemlist.end()) {
+		if (++overIndex < over.size()) {
+			cur = over[overIndex]->itemlist.begin();
 		}
 	}
 }
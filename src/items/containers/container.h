@@ -22,6 +22,8 @@
 
 #include <queue>
 
+#include <boost/container/small_vector.hpp>
+
 #include "items/cylinder.h"
 #include "items/item.h"
 
@@ -35,14 +37,18 @@ class ContainerIterator
 {
 	public:
 		bool hasNext() const {
-			return !over.empty();
+			return overIndex < over.size();
 		}
 
 		void advance();
 		Item* operator*();
 
 	private:
-		std::list<const Container*> over;
+		// breadth-first queue of containers, kept inline for typical backpack nesting
+		static constexpr size_t INLINE_CONTAINERS = 32;
+
+		boost::container::small_vector<const Container*, INLINE_CONTAINERS> over;
+		size_t overIndex = 0;
 		ItemDeque::const_iterator cur;
 
 		friend class Container;
@@ -36,80 +36,122 @@ void Decay::startDecay(Item* item, int32_t duration)
 		stopDecay(item, item->getIntAttr(ITEM_ATTRIBUTE_DURATION_TIMESTAMP));
 	}
 
-	int64_t timestamp = OTSYS_TIME() + static_cast<int64_t>(duration);
-	if (decayMap.empty()) {
-		eventId = g_scheduler.addEvent(createSchedulerTask(std::max<int32_t>(SCHEDULER_MINTICKS, duration), std::bind(&Decay::checkDecay, this)));
-	} else {
-		if (timestamp < decayMap.begin()->first) {
-			g_scheduler.stopEvent(eventId);
-			eventId = g_scheduler.addEvent(createSchedulerTask(std::max<int32_t>(SCHEDULER_MINTICKS, duration), std::bind(&Decay::checkDecay, this)));
-		}
+	int64_t now = OTSYS_TIME();
+	if (wheelSize == 0) {
+		wheelTime = now - (now % DECAY_WHEEL_TICK);
 	}
 
+	int64_t timestamp = now + static_cast<int64_t>(duration);
+	std::vector<Item*>& slot = getSlot(wheel, timestamp);
+	item->decayIndex = static_cast<uint32_t>(slot.size());
+	slot.push_back(item);
+	++wheelSize;
+
 	item->incrementReferenceCounter();
 	item->setDecaying(DECAYING_TRUE);
 	item->setDurationTimestamp(timestamp);
-	decayMap[timestamp].push_back(item);
+
+	if (eventId == 0) {
+		scheduleCheck(static_cast<int32_t>(wheelTime + DECAY_WHEEL_TICK - now));
+	}
 }
 
 void Decay::stopDecay(Item* item, int64_t timestamp)
 {
-	auto it = decayMap.find(timestamp);
-	if (it != decayMap.end()) {
-		std::vector<Item*>& decayItems = it->second;
-
-		size_t i = 0, end = decayItems.size();
-		if (end == 1) {
-			if (item == decayItems[i]) {
-				if (item->hasAttribute(ITEM_ATTRIBUTE_DURATION)) {
-					// Incase we removed duration attribute don't assign new duration
-					item->setDuration(item->getDuration());
-				}
-				item->removeAttribute(ITEM_ATTRIBUTE_DECAYSTATE);
-				g_game.ReleaseItem(item);
-
-				decayMap.erase(it);
-			}
+	uint32_t index = item->decayIndex & ~EXPIRED_FLAG;
+	if ((item->decayIndex & EXPIRED_FLAG) != 0) {
+		if (index >= expiredItems.size() || expiredItems[index] != item) {
+			return;
+		}
+
+		Item* last = expiredItems.back();
+		last->decayIndex = index | EXPIRED_FLAG;
+		expiredItems[index] = last;
+		expiredItems.pop_back();
+	} else {
+		std::vector<Item*>& slot = getSlot(wheel, timestamp);
+		if (index >= slot.size() || slot[index] != item) {
 			return;
 		}
-		while (i < end) {
-			if (item == decayItems[i]) {
-				if (item->hasAttribute(ITEM_ATTRIBUTE_DURATION)) {
-					// Incase we removed duration attribute don't assign new duration
-					item->setDuration(item->getDuration());
-				}
-				item->removeAttribute(ITEM_ATTRIBUTE_DECAYSTATE);
-				g_game.ReleaseItem(item);
-
-				std::swap(decayItems[i], decayItems.back());
-				decayItems.pop_back();
-				return;
-			}
+
+		Item* last = slot.back();
+		last->decayIndex = index;
+		slot[index] = last;
+		slot.pop_back();
+		--wheelSize;
+	}
+
+	item->decayIndex = 0;
+	if (item->hasAttribute(ITEM_ATTRIBUTE_DURATION)) {
+		// Incase we removed duration attribute don't assign new duration
+		item->setDuration(item->getDuration());
+	}
+	item->removeAttribute(ITEM_ATTRIBUTE_DECAYSTATE);
+	g_game.ReleaseItem(item);
+}
+
+void Decay::collectExpired(std::vector<Item*>& slot, int64_t slotEnd)
+{
+	size_t i = 0;
+	while (i < slot.size()) {
+		Item* item = slot[i];
+		if (item->getIntAttr(ITEM_ATTRIBUTE_DURATION_TIMESTAMP) >= slotEnd) {
+			// due in a later rotation of the wheel
 			++i;
+			continue;
 		}
+
+		Item* last = slot.back();
+		last->decayIndex = static_cast<uint32_t>(i);
+		slot[i] = last;
+		slot.pop_back();
+		--wheelSize;
+
+		expiredItems.push_back(item);
 	}
 }
 
+void Decay::scheduleCheck(int32_t delay)
+{
+	eventId = g_scheduler.addEvent(createSchedulerTask(std::max<int32_t>(SCHEDULER_MINTICKS, delay), std::bind(&Decay::checkDecay, this)));
+}
+
 void Decay::checkDecay()
 {
-	int64_t timestamp = OTSYS_TIME();
+	eventId = 0;
+
+	int64_t now = OTSYS_TIME();
+	size_t expiredBefore = expiredItems.size();
+	for (; wheelTime + DECAY_WHEEL_TICK <= now && wheelSize != 0; wheelTime += DECAY_WHEEL_TICK) {
+		collectExpired(getSlot(wheel, wheelTime), wheelTime + DECAY_WHEEL_TICK);
+	}
 
-	std::vector<Item*> tempItems;
-	tempItems.reserve(32);  // Small preallocation
+	if (wheelSize == 0) {
+		wheelTime = now - (now % DECAY_WHEEL_TICK);
+	}
 
-	auto it = decayMap.begin(), end = decayMap.end();
-	while (it != end) {
-		if (it->first > timestamp) {
+	if (expiredItems.size() != expiredBefore) {
+		// items are taken from the back, keep the ones sharing a tile next to each
+		// other so their spectator updates reuse the same spectator lookup
+		std::sort(expiredItems.begin(), expiredItems.end(), [](Item* lhs, Item* rhs) {
+			return std::greater<Tile*>()(lhs->getTile(), rhs->getTile());
+		});
+		for (size_t i = 0, size = expiredItems.size(); i < size; ++i) {
+			expiredItems[i]->decayIndex = static_cast<uint32_t>(i) | EXPIRED_FLAG;
+		}
+	}
+
+	size_t processed = 0;
+	while (!expiredItems.empty()) {
+		// only look at the clock every few items
+		if ((++processed % 64) == 0 && OTSYS_TIME() - now >= DECAY_BATCH_BUDGET) {
 			break;
 		}
 
-		// Iterating here is unsafe so let's copy our items into temporary vector
-		std::vector<Item*>& decayItems = it->second;
-		tempItems.insert(tempItems.end(), decayItems.begin(), decayItems.end());
-		it = decayMap.erase(it);
-	}
+		Item* item = expiredItems.back();
+		expiredItems.pop_back();
+		item->decayIndex = 0;
 
-	for (Item* item : tempItems) {
 		if (!item->canDecay()) {
 			item->setDuration(item->getDuration());
 			item->setDecaying(DECAYING_FALSE);
@@ -121,7 +163,14 @@ void Decay::checkDecay()
 		g_game.ReleaseItem(item);
 	}
 
-	if (it != end) {
-		eventId = g_scheduler.addEvent(createSchedulerTask(std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(it->first - timestamp)), std::bind(&Decay::checkDecay, this)));
+	if (eventId != 0) {
+		// an item started decaying while processing and already scheduled the next sweep
+		return;
 	}
-}
\ No newline at end of file
+
+	if (!expiredItems.empty()) {
+		scheduleCheck(SCHEDULER_MINTICKS);
+	} else if (wheelSize != 0) {
+		scheduleCheck(static_cast<int32_t>(wheelTime + DECAY_WHEEL_TICK - OTSYS_TIME()));
+	}
+}
@@ -22,7 +22,14 @@
 
 #include "items/item.h"
 
-#include <map>
+#include <array>
+
+// width of a decay wheel slot, deadlines are rounded up to it
+static constexpr int32_t DECAY_WHEEL_TICK = 100;
+// the wheel covers DECAY_WHEEL_SLOTS * DECAY_WHEEL_TICK ms, longer durations wait for extra rotations
+static constexpr size_t DECAY_WHEEL_SLOTS = 4096;
+// milliseconds spent transforming expired items before yielding to the dispatcher
+static constexpr int64_t DECAY_BATCH_BUDGET = 10;
 
 class Decay
 {
@@ -31,12 +38,25 @@ class Decay
 		void stopDecay(Item* item, int64_t timestamp);
 
 	private:
-		void checkDecay();
+		static constexpr uint32_t EXPIRED_FLAG = 1u << 31;
 
+		static std::vector<Item*>& getSlot(std::array<std::vector<Item*>, DECAY_WHEEL_SLOTS>& wheel, int64_t timestamp) {
+			return wheel[(timestamp / DECAY_WHEEL_TICK) % DECAY_WHEEL_SLOTS];
+		}
+
+		void checkDecay();
+		void collectExpired(std::vector<Item*>& slot, int64_t slotEnd);
+		void scheduleCheck(int32_t delay);
+
+		std::array<std::vector<Item*>, DECAY_WHEEL_SLOTS> wheel;
+		// due items waiting for their transformation, ordered by tile
+		std::vector<Item*> expiredItems;
+		// start of the oldest slot not yet swept
+		int64_t wheelTime = 0;
+		size_t wheelSize = 0;
 		uint32_t eventId {0};
-		std::map<int64_t, std::vector<Item*>> decayMap;
 };
 
 extern Decay g_decay;
 
-#endif  // SRC_ITEMS_DECAY_DECAY_H_
\ No newline at end of file
+#endif  // SRC_ITEMS_DECAY_DECAY_H_
@@ -39,8 +39,10 @@ extern Spells* g_spells;
 extern Vocations g_vocations;
 extern Imbuements g_imbuements;
 extern Forge g_forge;
+extern LuaEnvironment g_luaEnvironment;
 
 Items Item::items;
+thread_local bool Item::deferRegistration = false;
 
 Item* Item::CreateItem(const uint16_t type, uint16_t count /*= 0*/)
 {
@@ -204,6 +206,15 @@ Item::Item(const Item& i) :
 	}
 }
 
+Item::~Item()
+{
+	// a later object at this address must not reuse the userdata and its metatable
+	lua_State* L = luaUserdata ? g_luaEnvironment.getLuaState() : nullptr;
+	if (L) {
+		LuaScriptInterface::removeCachedUserdata(L, this);
+	}
+}
+
 Item* Item::clone() const
 {
 	Item* item = Item::CreateItem(id, count);
@@ -2581,7 +2592,7 @@ void Item::setUniqueId(uint16_t n)
 		return;
 	}
 
-	if (g_game.addUniqueItem(n, this)) {
+	if (deferRegistration || g_game.addUniqueItem(n, this)) {
 		getAttributes()->setUniqueId(n);
 	}
 }
@@ -2632,6 +2643,47 @@ int64_t ItemAttributes::emptyInt;
 double ItemAttributes::emptyDouble;
 bool ItemAttributes::emptyBool;
 
+namespace {
+
+// locked because map tile areas are loaded on worker threads
+struct StringPool {
+	std::mutex lock;
+	std::unordered_map<std::string, uint32_t> strings;
+};
+
+// never destroyed: items owned by globals may still be freed after static
+// destruction has started
+StringPool& getStringPool()
+{
+	static StringPool* pool = new StringPool;
+	return *pool;
+}
+
+}
+
+const std::string* ItemAttributes::acquireString(const std::string& value)
+{
+	StringPool& pool = getStringPool();
+	std::lock_guard<std::mutex> lockGuard(pool.lock);
+	auto it = pool.strings.emplace(value, 0).first;
+	++it->second;
+	return &it->first;
+}
+
+void ItemAttributes::releaseString(const std::string* value)
+{
+	if (!value) {
+		return;
+	}
+
+	StringPool& pool = getStringPool();
+	std::lock_guard<std::mutex> lockGuard(pool.lock);
+	auto it = pool.strings.find(*value);
+	if (it != pool.strings.end() && --it->second == 0) {
+		pool.strings.erase(it);
+	}
+}
+
 const std::string& ItemAttributes::getStrAttr(itemAttrTypes type) const
 {
 	if (!isStrAttrType(type)) {
@@ -2656,8 +2708,14 @@ void ItemAttributes::setStrAttr(itemAttrTypes type, const std::string& value)
 	}
 
 	Attribute& attr = getAttr(type);
-	delete attr.value.string;
-	attr.value.string = new std::string(value);
+	if (isInternedAttrType(type)) {
+		const std::string* interned = acquireString(value);
+		releaseString(attr.value.string);
+		attr.value.string = interned;
+	} else {
+		delete attr.value.string;
+		attr.value.string = new std::string(value);
+	}
 }
 
 void ItemAttributes::removeAttribute(itemAttrTypes type)
@@ -2666,17 +2724,14 @@ void ItemAttributes::removeAttribute(itemAttrTypes type)
 		return;
 	}
 
-	auto prev_it = attributes.cbegin();
-	if ((*prev_it).type == type) {
-		attributes.pop_front();
-	} else {
-		auto it = prev_it, end = attributes.cend();
-		while (++it != end) {
-			if ((*it).type == type) {
-				attributes.erase_after(prev_it);
-				break;
+	for (auto it = attributes.begin(), end = attributes.end(); it != end; ++it) {
+		if (it->type == type) {
+			// order is irrelevant, so fill the hole with the last entry
+			if (it != end - 1) {
+				*it = std::move(attributes.back());
 			}
-			prev_it = it;
+			attributes.pop_back();
+			break;
 		}
 	}
 	attributeBits &= ~type;
@@ -2736,8 +2791,8 @@ ItemAttributes::Attribute& ItemAttributes::getAttr(itemAttrTypes type)
 	}
 
 	attributeBits |= type;
-	attributes.emplace_front(type);
-	return attributes.front();
+	attributes.emplace_back(type);
+	return attributes.back();
 }
 
 void Item::startDecaying()
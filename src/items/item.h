@@ -30,6 +30,7 @@
 #include "utils/tools.h"
 #include <typeinfo>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/variant.hpp>
 #include <boost/lexical_cast.hpp>
 #include <deque>
@@ -373,7 +374,8 @@ class ItemAttributes
 		{
 			union {
 				int64_t integer;
-				std::string* string;
+				// owned by the attribute, or a pooled copy for interned types
+				const std::string* string;
 				CustomAttributeMap* custom;
 			} value;
 			itemAttrTypes type;
@@ -385,6 +387,8 @@ class ItemAttributes
 				type = i.type;
 				if (ItemAttributes::isIntAttrType(type)) {
 					value.integer = i.value.integer;
+				} else if (ItemAttributes::isInternedAttrType(type)) {
+					value.string = ItemAttributes::acquireString(*i.value.string);
 				} else if (ItemAttributes::isStrAttrType(type)) {
 					value.string = new std::string(*i.value.string);
 				} else if (ItemAttributes::isCustomAttrType(type)) {
@@ -393,28 +397,21 @@ class ItemAttributes
 					memset(&value, 0, sizeof(value));
 				}
 			}
-			Attribute(Attribute&& attribute) : value(attribute.value), type(attribute.type) {
+			Attribute(Attribute&& attribute) noexcept : value(attribute.value), type(attribute.type) {
 				memset(&attribute.value, 0, sizeof(value));
 				attribute.type = ITEM_ATTRIBUTE_NONE;
 			}
 			~Attribute() {
-				if (ItemAttributes::isStrAttrType(type)) {
-					delete value.string;
-				} else if (ItemAttributes::isCustomAttrType(type)) {
-					delete value.custom;
-				}
+				clear();
 			}
-			Attribute& operator=(Attribute other) {
-				Attribute::swap(*this, other);
+			Attribute& operator=(const Attribute& other) {
+				Attribute tmp(other);
+				Attribute::swap(*this, tmp);
 				return *this;
 			}
-			Attribute& operator=(Attribute&& other) {
+			Attribute& operator=(Attribute&& other) noexcept {
 				if (this != &other) {
-					if (ItemAttributes::isStrAttrType(type)) {
-						delete value.string;
-					} else if (ItemAttributes::isCustomAttrType(type)) {
-						delete value.custom;
-					}
+					clear();
 
 					value = other.value;
 					type = other.type;
@@ -425,15 +422,34 @@ class ItemAttributes
 				return *this;
 			}
 
+			void clear() {
+				if (ItemAttributes::isInternedAttrType(type)) {
+					ItemAttributes::releaseString(value.string);
+				} else if (ItemAttributes::isStrAttrType(type)) {
+					delete value.string;
+				} else if (ItemAttributes::isCustomAttrType(type)) {
+					delete value.custom;
+				}
+				memset(&value, 0, sizeof(value));
+			}
+
 			static void swap(Attribute& first, Attribute& second) {
 				std::swap(first.value, second.value);
 				std::swap(first.type, second.type);
 			}
 		};
 
-		std::forward_list<Attribute> attributes;
+		// most items carry at most duration, decay state and its timestamp
+		static constexpr size_t INLINE_ATTRIBUTES = 3;
+		using AttributeList = boost::container::small_vector<Attribute, INLINE_ATTRIBUTES>;
+
+		AttributeList attributes;
 		uint32_t attributeBits = 0;
 
+		// reference counted pool shared by all items for low-cardinality string attributes
+		static const std::string* acquireString(const std::string& value);
+		static void releaseString(const std::string* value);
+
 		const std::string& getStrAttr(itemAttrTypes type) const;
 		void setStrAttr(itemAttrTypes type, const std::string& value);
 
@@ -525,6 +541,10 @@ class ItemAttributes
 		const static uint32_t stringAttributeTypes = ITEM_ATTRIBUTE_DESCRIPTION | ITEM_ATTRIBUTE_TEXT | ITEM_ATTRIBUTE_WRITER
 			| ITEM_ATTRIBUTE_NAME | ITEM_ATTRIBUTE_ARTICLE | ITEM_ATTRIBUTE_PLURALNAME | ITEM_ATTRIBUTE_SPECIAL;
 
+		// repeated across many items (writers, corpse and house descriptions, renamed items)
+		const static uint32_t internedAttributeTypes = ITEM_ATTRIBUTE_DESCRIPTION | ITEM_ATTRIBUTE_WRITER
+			| ITEM_ATTRIBUTE_NAME | ITEM_ATTRIBUTE_ARTICLE | ITEM_ATTRIBUTE_PLURALNAME;
+
 	public:
 		static bool isIntAttrType(itemAttrTypes type) {
 			return (type & intAttributeTypes) == type;
@@ -532,11 +552,14 @@ class ItemAttributes
 		static bool isStrAttrType(itemAttrTypes type) {
 			return (type & stringAttributeTypes) == type;
 		}
+		static bool isInternedAttrType(itemAttrTypes type) {
+			return type != ITEM_ATTRIBUTE_NONE && (type & internedAttributeTypes) == type;
+		}
 		inline static bool isCustomAttrType(itemAttrTypes type) {
 			return (type & 0x80000000) != 0;
 		}
 
-		const std::forward_list<Attribute>& getList() const {
+		const AttributeList& getList() const {
 			return attributes;
 		}
 
@@ -552,12 +575,16 @@ class Item : virtual public Thing
 		static Item* CreateItem(PropStream& propStream);
 		static Items items;
 
+		// Set on map loader threads: unique ids and bed sleepers read there are
+		// only kept on the item and registered with the game once it is placed
+		static thread_local bool deferRegistration;
+
 		// Constructor for items
 		Item(const uint16_t type, uint16_t count = 0);
 		Item(const Item& i);
 		virtual Item* clone() const;
 
-		virtual ~Item() = default;
+		virtual ~Item();
 
 		// non-assignable
 		Item& operator=(const Item&) = delete;
@@ -1103,6 +1130,11 @@ class Item : virtual public Thing
 			}
 		}
 
+		// set when a script is handed this item, see LuaScriptInterface::pushCachedUserdata
+		void setLuaUserdata() {
+			luaUserdata = true;
+		}
+
 		Cylinder* getParent() const override {
 			return parent;
 		}
@@ -1135,6 +1167,10 @@ class Item : virtual public Thing
 
 		bool loadedFromMap = false;
 		bool isLootTrackeable = false;
+		bool luaUserdata = false;
+
+		// slot position kept by Decay for constant time removal, fits in the padding above
+		uint32_t decayIndex = 0;
 
 		//Don't add variables here, use the ItemAttribute class.
 		friend class Decay;
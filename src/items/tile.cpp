@@ -39,6 +39,80 @@ extern Game g_game;
 extern ConfigManager g_config;
 extern MoveEvents* g_moveEvents;
 
+namespace {
+
+constexpr size_t TILE_ALIGNMENT = alignof(std::max_align_t);
+constexpr size_t TILE_MAX_SIZE = 256;
+constexpr size_t TILE_SIZE_CLASSES = TILE_MAX_SIZE / TILE_ALIGNMENT;
+constexpr size_t TILE_BLOCK_SIZE = 64 * 1024;
+
+struct TileFreeNode {
+	TileFreeNode* next;
+};
+
+struct TileAllocatorState {
+	std::mutex lock;
+	TileFreeNode* freeLists[TILE_SIZE_CLASSES] = {};
+	uint8_t* blockCursor = nullptr;
+	uint8_t* blockEnd = nullptr;
+};
+
+// never destroyed: tiles owned by globals may still be freed after static
+// destruction has started
+TileAllocatorState& getTileAllocatorState()
+{
+	static TileAllocatorState* state = new TileAllocatorState;
+	return *state;
+}
+
+}
+
+void* TileAllocator::allocate(size_t size)
+{
+	if (size > TILE_MAX_SIZE) {
+		return ::operator new(size);
+	}
+
+	size_t sizeClass = (size + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT;
+	TileAllocatorState& state = getTileAllocatorState();
+	std::lock_guard<std::mutex> lockGuard(state.lock);
+	TileFreeNode*& freeList = state.freeLists[sizeClass - 1];
+	if (freeList) {
+		TileFreeNode* node = freeList;
+		freeList = node->next;
+		return node;
+	}
+
+	size_t bytes = sizeClass * TILE_ALIGNMENT;
+	if (static_cast<size_t>(state.blockEnd - state.blockCursor) < bytes) {
+		state.blockCursor = static_cast<uint8_t*>(::operator new(TILE_BLOCK_SIZE));
+		state.blockEnd = state.blockCursor + TILE_BLOCK_SIZE;
+	}
+
+	void* p = state.blockCursor;
+	state.blockCursor += bytes;
+	return p;
+}
+
+void TileAllocator::deallocate(void* p, size_t size)
+{
+	if (!p) {
+		return;
+	}
+
+	if (size > TILE_MAX_SIZE) {
+		::operator delete(p);
+		return;
+	}
+
+	size_t sizeClass = (size + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT;
+	TileAllocatorState& state = getTileAllocatorState();
+	std::lock_guard<std::mutex> lockGuard(state.lock);
+	TileFreeNode* node = static_cast<TileFreeNode*>(p);
+	node->next = state.freeLists[sizeClass - 1];
+	state.freeLists[sizeClass - 1] = node;
+}
+
 StaticTile real_nullptr_tile(0xFFFF, 0xFFFF, 0xFF);
 Tile& Tile::nullptr_tile = real_nullptr_tile;
 
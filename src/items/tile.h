@@ -38,6 +38,18 @@ using CreatureVector = std::vector<Creature*>;
 using ItemVector = std::vector<Item*>;
 using SpectatorHashSet = std::unordered_set<Creature*>;
 
+// A loaded map keeps millions of tiles alive for the whole uptime, so they are
+// carved out of large blocks instead of going through malloc one by one: this
+// drops the per-allocation header and keeps tiles loaded together adjacent in
+// memory. Freed tiles go to a free list per size class and are never returned
+// to the system.
+class TileAllocator
+{
+	public:
+		static void* allocate(size_t size);
+		static void deallocate(void* p, size_t size);
+};
+
 enum tileflags_t : uint32_t {
 	TILESTATE_NONE = 0,
 
@@ -164,6 +176,14 @@ class Tile : public Cylinder
 		Tile(const Tile&) = delete;
 		Tile& operator=(const Tile&) = delete;
 
+		// the virtual destructor makes sized delete see the most derived type
+		static void* operator new(size_t size) {
+			return TileAllocator::allocate(size);
+		}
+		static void operator delete(void* p, size_t size) {
+			TileAllocator::deallocate(p, size);
+		}
+
 		virtual TileItemVector* getItemList() = 0;
 		virtual const TileItemVector* getItemList() const = 0;
 		virtual TileItemVector* makeItemList() = 0;
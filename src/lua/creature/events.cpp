@@ -1277,14 +1277,14 @@ void Events::eventPlayerOnCombat(Player* player, Creature* target, Item* item, C
 
 	if (target) {
 		LuaScriptInterface::pushUserdata<Creature>(L, target);
-		LuaScriptInterface::setMetatable(L, -1, "Creature");
+		LuaScriptInterface::setCreatureMetatable(L, -1, target);
 	} else {
 		lua_pushnil(L);
 	}
 
 	if(item){
 		LuaScriptInterface::pushUserdata<Item>(L, item);
-		LuaScriptInterface::setMetatable(L, -1, "Item");
+		LuaScriptInterface::setItemMetatable(L, -1, item);
 	}else{
 		lua_pushnil(L);
 	}
@@ -0,0 +1,215 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "otpch.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "lua/scripts/luabytecodecache.h"
+#include "lua/scripts/luascript.h"
+#include "config/configmanager.h"
+#include "utils/tools.h"
+
+extern ConfigManager g_config;
+
+namespace {
+
+const std::string CACHE_DIRECTORY = "cache/lua/";
+
+// bytecode is only valid for the interpreter build that produced it
+#ifdef LUAJIT_VERSION
+const std::string CACHE_VERSION = std::string(LUAJIT_VERSION) + "/" + std::to_string(sizeof(void*));
+#else
+const std::string CACHE_VERSION = std::string(LUA_RELEASE) + "/" + std::to_string(sizeof(void*));
+#endif
+
+int64_t getMicroseconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int writeChunk(lua_State*, const void* data, size_t size, void* userdata)
+{
+	static_cast<std::string*>(userdata)->append(static_cast<const char*>(data), size);
+	return 0;
+}
+
+void createCacheDirectory()
+{
+	static std::once_flag created;
+	std::call_once(created, []() {
+		boost::system::error_code error;
+		boost::filesystem::create_directories(CACHE_DIRECTORY, error);
+		if (error) {
+			SPDLOG_WARN("[LuaBytecodeCache] - Could not create {}: {}", CACHE_DIRECTORY, error.message());
+		}
+	});
+}
+
+}
+
+bool LuaBytecodeCache::readFile(const std::string& file, std::string& content)
+{
+	std::ifstream in(file, std::ifstream::binary);
+	if (!in) {
+		return false;
+	}
+
+	content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	return !in.bad();
+}
+
+std::string LuaBytecodeCache::getEntryName(const std::string& file, const std::string& source)
+{
+	// the path is hashed too, it is compiled in as the chunk name errors show
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (const std::string* data : {&CACHE_VERSION, &file, &source}) {
+		for (unsigned char c : *data) {
+			hash = (hash ^ c) * 0x100000001B3ULL;
+		}
+		hash = (hash ^ 0xFF) * 0x100000001B3ULL;
+	}
+
+	std::ostringstream ss;
+	ss << CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << hash << ".luac";
+	return ss.str();
+}
+
+int LuaBytecodeCache::compile(lua_State* L, const std::string& file, std::string source, const std::string& entryName)
+{
+	// luaL_loadfile skips a leading #! line, keep the line count for error messages
+	if (!source.empty() && source.front() == '#') {
+		source.erase(0, source.find('\n'));
+	}
+
+	const std::string chunkName = "@" + file;
+	int ret = luaL_loadbuffer(L, source.data(), source.size(), chunkName.c_str());
+	if (ret != 0) {
+		return ret;
+	}
+
+	std::string bytecode;
+	if (lua_dump(L, writeChunk, &bytecode) != 0 || bytecode.empty()) {
+		return 0;
+	}
+
+	// written aside and renamed, a reader never sees a partial entry
+	const std::string tempName = entryName + ".tmp";
+	std::ofstream out(tempName, std::ofstream::binary | std::ofstream::trunc);
+	out.write(bytecode.data(), bytecode.size());
+	out.close();
+	if (!out || std::rename(tempName.c_str(), entryName.c_str()) != 0) {
+		std::remove(tempName.c_str());
+	}
+	return 0;
+}
+
+int LuaBytecodeCache::load(lua_State* L, const std::string& file)
+{
+	int64_t start = getMicroseconds();
+	if (!g_config.getBoolean(ConfigManager::LUA_BYTECODE_CACHE)) {
+		int ret = luaL_loadfile(L, file.c_str());
+		stats.parseTime += getMicroseconds() - start;
+		return ret;
+	}
+
+	std::string source;
+	if (!readFile(file, source)) {
+		// let Lua report why the file cannot be read
+		return luaL_loadfile(L, file.c_str());
+	}
+
+	createCacheDirectory();
+	const std::string entryName = getEntryName(file, source);
+
+	std::string bytecode;
+	if (readFile(entryName, bytecode)) {
+		const std::string chunkName = "@" + file;
+		if (luaL_loadbuffer(L, bytecode.data(), bytecode.size(), chunkName.c_str()) == 0) {
+			++stats.hits;
+			stats.parseTime += getMicroseconds() - start;
+			return 0;
+		}
+		// unreadable entry, compiled again below and replaced
+		lua_pop(L, 1);
+	}
+
+	++stats.misses;
+	int ret = compile(L, file, std::move(source), entryName);
+	stats.parseTime += getMicroseconds() - start;
+	return ret;
+}
+
+void LuaBytecodeCache::precompile(const std::vector<std::string>& files)
+{
+	size_t threadCount = std::max<int32_t>(g_config.getNumber(ConfigManager::LUA_PRECOMPILE_THREADS), 0);
+	if (threadCount == 0 || files.empty() || !g_config.getBoolean(ConfigManager::LUA_BYTECODE_CACHE)) {
+		return;
+	}
+	threadCount = std::min(threadCount, files.size());
+
+	createCacheDirectory();
+	int64_t start = OTSYS_TIME();
+
+	std::atomic<size_t> nextFile{0};
+	std::atomic<uint32_t> compiled{0};
+	auto compileFiles = [&files, &nextFile, &compiled]() {
+		lua_State* L = luaL_newstate();
+		if (!L) {
+			return;
+		}
+
+		size_t index;
+		while ((index = nextFile.fetch_add(1, std::memory_order_relaxed)) < files.size()) {
+			const std::string& file = files[index];
+			std::string source;
+			if (!readFile(file, source)) {
+				continue;
+			}
+
+			// syntax errors are left for load() to report
+			const std::string entryName = getEntryName(file, source);
+			if (!boost::filesystem::exists(entryName) && compile(L, file, std::move(source), entryName) == 0) {
+				compiled.fetch_add(1, std::memory_order_relaxed);
+			}
+			lua_settop(L, 0);
+		}
+		lua_close(L);
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back(compileFiles);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	if (compiled > 0) {
+		SPDLOG_INFO("Precompiled {} scripts in {} seconds using {} threads",
+		                compiled.load(), (OTSYS_TIME() - start) / (1000.), threadCount);
+	}
+}
@@ -0,0 +1,75 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef FS_LUABYTECODECACHE_H_6D1F8B3A2E9C4A7D5B0E3F6C1A8D2B47
+#define FS_LUABYTECODECACHE_H_6D1F8B3A2E9C4A7D5B0E3F6C1A8D2B47
+
+struct lua_State;
+
+/**
+ * On-disk cache of compiled script chunks. Entries are named after a hash of
+ * the script path and source, so an edited script simply misses and is
+ * compiled again; nothing has to be invalidated by hand. Stale entries are
+ * never read and can be deleted at any time.
+ */
+class LuaBytecodeCache
+{
+	public:
+		static LuaBytecodeCache& getInstance() {
+			static LuaBytecodeCache instance;
+			return instance;
+		}
+
+		// Parse and execute time of the scripts loaded since the last reset
+		struct LoadStats {
+			int64_t parseTime = 0;
+			int64_t executeTime = 0;
+			uint32_t hits = 0;
+			uint32_t misses = 0;
+		};
+
+		// Pushes the compiled chunk of file like luaL_loadfile does
+		int load(lua_State* L, const std::string& file);
+
+		// Compiles the scripts missing from the cache on worker threads, each
+		// with its own Lua state, so load() finds them all already compiled
+		void precompile(const std::vector<std::string>& files);
+
+		void addExecuteTime(int64_t time) {
+			stats.executeTime += time;
+		}
+		LoadStats resetStats() {
+			LoadStats result = stats;
+			stats = LoadStats();
+			return result;
+		}
+
+	private:
+		LuaBytecodeCache() = default;
+
+		static bool readFile(const std::string& file, std::string& content);
+		static std::string getEntryName(const std::string& file, const std::string& source);
+		// leaves the chunk, or the error message, on top of the stack
+		static int compile(lua_State* L, const std::string& file, std::string source, const std::string& entryName);
+
+		LoadStats stats;
+};
+
+#endif
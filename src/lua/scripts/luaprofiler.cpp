@@ -0,0 +1,198 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "otpch.h"
+
+#include <array>
+#include <fstream>
+
+#include "lua/scripts/luaprofiler.h"
+#include "lua/scripts/luascript.h"
+#include "utils/tools.h"
+
+void LuaProfiler::start(lua_State* L)
+{
+	if (running) {
+		return;
+	}
+
+	stacks.clear();
+	cCalls.clear();
+	lastStack.clear();
+	callDepth = 0;
+	startedAt = OTSYS_TIME();
+	lastSample = Clock::now();
+	running = true;
+	lua_sethook(L, hook, LUA_MASKCOUNT | LUA_MASKCALL | LUA_MASKRET, SAMPLE_INSTRUCTIONS);
+	SPDLOG_INFO("Lua profiler started");
+}
+
+std::string LuaProfiler::stop(lua_State* L)
+{
+	if (!running) {
+		return std::string();
+	}
+
+	lua_sethook(L, nullptr, 0, 0);
+	running = false;
+
+	std::vector<std::pair<std::string, uint64_t>> sorted(stacks.begin(), stacks.end());
+	std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+		return a.second > b.second;
+	});
+	stacks.clear();
+
+	std::string fileName = "stats/lua_profile_" + std::to_string(startedAt / 1000) + ".folded";
+	std::ofstream out(fileName, std::ofstream::out | std::ofstream::trunc);
+	if (!out.is_open()) {
+		SPDLOG_ERROR("[LuaProfiler::stop] - Can't open {} (check if directory exists)", fileName);
+		return std::string();
+	}
+
+	uint64_t total = 0;
+	for (const auto& it : sorted) {
+		out << it.first << ' ' << it.second << '\n';
+		total += it.second;
+	}
+	out.close();
+
+	SPDLOG_INFO("Lua profiler stopped, {} ms in {} stacks written to {}", total / 1000, sorted.size(), fileName);
+	return fileName;
+}
+
+void LuaProfiler::enterCall()
+{
+	if (callDepth++ == 0) {
+		lastSample = Clock::now();
+	}
+}
+
+void LuaProfiler::leaveCall()
+{
+	if (callDepth == 0) {
+		return;
+	}
+
+	if (--callDepth == 0) {
+		// the outermost return already charged the call, this is what an
+		// error unwinding past it left over
+		charge(lastStack, Clock::now());
+		cCalls.clear();
+	}
+}
+
+void LuaProfiler::hook(lua_State* L, lua_Debug* ar)
+{
+	LuaProfiler& profiler = getInstance();
+	switch (ar->event) {
+		case LUA_HOOKCOUNT:
+			profiler.charge(getStack(L, 0), Clock::now());
+			break;
+
+		case LUA_HOOKCALL:
+			lua_getinfo(L, "S", ar);
+			if (*ar->what == 'C') {
+				profiler.cCalls.push_back(Clock::now());
+			}
+			break;
+
+		case LUA_HOOKRET: {
+			lua_getinfo(L, "S", ar);
+			if (*ar->what == 'C') {
+				profiler.leaveCFunction(L);
+				break;
+			}
+
+			// the tail of a call from the server, after its last sample
+			lua_Debug caller;
+			if (lua_getstack(L, 1, &caller) == 0) {
+				profiler.charge(getStack(L, 0), Clock::now());
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+void LuaProfiler::leaveCFunction(lua_State* L)
+{
+	if (cCalls.empty()) {
+		return;
+	}
+
+	Clock::time_point callStart = cCalls.back();
+	cCalls.pop_back();
+
+	Clock::time_point now = Clock::now();
+	if (std::chrono::duration_cast<std::chrono::microseconds>(now - callStart).count() < MIN_C_CALL_TIME) {
+		return;
+	}
+
+	// Lua time up to the call belongs to the caller, the rest to the binding
+	if (lastSample < callStart) {
+		charge(getStack(L, 1), callStart);
+	}
+	charge(getStack(L, 0), now);
+}
+
+void LuaProfiler::charge(const std::string& stack, Clock::time_point until)
+{
+	uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(until - lastSample).count();
+	lastSample = until;
+	if (elapsed == 0 || stack.empty()) {
+		return;
+	}
+
+	stacks[stack] += elapsed;
+	lastStack = stack;
+}
+
+std::string LuaProfiler::getStack(lua_State* L, int firstLevel)
+{
+	lua_Debug ar;
+	std::array<std::string, MAX_DEPTH> frames;
+	int depth = 0;
+	while (depth < MAX_DEPTH && lua_getstack(L, firstLevel + depth, &ar) == 1) {
+		lua_getinfo(L, "Sln", &ar);
+		std::string& frame = frames[depth++];
+		if (*ar.what == 'C') {
+			frame = "[C] ";
+			frame.append(ar.name ? ar.name : "?");
+		} else {
+			frame = ar.name ? ar.name : (*ar.what == 'm' ? "main" : "?");
+			frame.push_back(' ');
+			frame.append(ar.short_src);
+			frame.push_back(':');
+			frame.append(std::to_string(ar.currentline));
+		}
+		std::replace(frame.begin(), frame.end(), ';', ',');
+	}
+
+	// collapsed stacks are written outermost frame first
+	std::string stack;
+	for (int i = depth - 1; i >= 0; --i) {
+		stack.append(frames[i]);
+		if (i != 0) {
+			stack.push_back(';');
+		}
+	}
+	return stack;
+}
@@ -0,0 +1,82 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef FS_LUAPROFILER_H_9B4D2E7A1C6F4B3E8D5A0F2C7E1B9D64
+#define FS_LUAPROFILER_H_9B4D2E7A1C6F4B3E8D5A0F2C7E1B9D64
+
+struct lua_State;
+struct lua_Debug;
+
+/**
+ * Opt-in sampling profiler for the scripting state. A count hook samples the
+ * Lua call stack every few hundred instructions and charges the time elapsed
+ * since the previous sample to it. Call and return hooks time C bindings, so
+ * a slow binding is charged to its own "[C] name" frame instead of the next
+ * sample. Stopping writes the result as collapsed stacks (one
+ * "frame;frame;frame microseconds" line each), the input format of
+ * flamegraph.pl and speedscope.
+ */
+class LuaProfiler
+{
+	public:
+		static LuaProfiler& getInstance() {
+			static LuaProfiler instance;
+			return instance;
+		}
+
+		bool isRunning() const {
+			return running;
+		}
+
+		void start(lua_State* L);
+		// returns the file the profile was written to, empty on failure
+		std::string stop(lua_State* L);
+
+		// brackets calls from the server into Lua, so time spent outside of
+		// scripts is not charged to the first sample of the next call
+		void enterCall();
+		void leaveCall();
+
+	private:
+		LuaProfiler() = default;
+
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr int SAMPLE_INSTRUCTIONS = 500;
+		static constexpr int MAX_DEPTH = 64;
+		// shorter bindings are left to the samples, building a stack costs more
+		static constexpr int64_t MIN_C_CALL_TIME = 10;
+
+		static void hook(lua_State* L, lua_Debug* ar);
+		static std::string getStack(lua_State* L, int firstLevel);
+		// charges the time since the last charge to stack
+		void charge(const std::string& stack, Clock::time_point until);
+		void leaveCFunction(lua_State* L);
+
+		std::unordered_map<std::string, uint64_t> stacks;
+		// start of each C function running, innermost last
+		std::vector<Clock::time_point> cCalls;
+		std::string lastStack;
+		Clock::time_point lastSample;
+		int64_t startedAt = 0;
+		int callDepth = 0;
+		bool running = false;
+};
+
+#endif
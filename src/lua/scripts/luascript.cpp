@@ -22,6 +22,8 @@
 #include <boost/range/adaptor/reversed.hpp>
 
 #include "lua/scripts/luascript.h"
+#include "lua/scripts/luaprofiler.h"
+#include "lua/scripts/luabytecodecache.h"
 #include "creatures/interactions/chat.h"
 #include "creatures/players/player.h"
 #include "game/game.h"
@@ -280,6 +282,10 @@ std::string LuaScriptInterface::getErrorDesc(ErrorCode_t code)
 ScriptEnvironment LuaScriptInterface::scriptEnv[16];
 int32_t LuaScriptInterface::scriptEnvIndex = -1;
 
+std::unordered_map<std::string, int> LuaScriptInterface::metatableRefs;
+std::array<int, LuaData_Tile + 1> LuaScriptInterface::dataTypeMetatableRefs;
+int LuaScriptInterface::userdataCacheRef = LUA_NOREF;
+
 LuaScriptInterface::LuaScriptInterface(std::string initInterfaceName) : interfaceName(std::move(initInterfaceName))
 {
 	if (!g_luaEnvironment.getLuaState()) {
@@ -308,7 +314,16 @@ int LuaScriptInterface::protectedCall(lua_State* L, int nargs, int nresults)
 	lua_pushcfunction(L, luaErrorHandler);
 	lua_insert(L, error_index);
 
+	LuaProfiler& profiler = LuaProfiler::getInstance();
+	if (profiler.isRunning()) {
+		profiler.enterCall();
+	}
+
+	TraceSpan span("lua", scriptEnvIndex >= 0 ? getScriptEnv()->getScriptId() : 0);
 	int ret = lua_pcall(L, nargs, nresults, error_index);
+	if (profiler.isRunning()) {
+		profiler.leaveCall();
+	}
 	lua_remove(L, error_index);
 	return ret;
 }
@@ -316,7 +331,7 @@ int LuaScriptInterface::protectedCall(lua_State* L, int nargs, int nresults)
 int32_t LuaScriptInterface::loadFile(const std::string& file, Npc* npc /* = nullptr*/)
 {
 	//loads file as a chunk at stack top
-	int ret = luaL_loadfile(luaState, file.c_str());
+	int ret = LuaBytecodeCache::getInstance().load(luaState, file);
 	if (ret != 0) {
 		lastLuaError = popString(luaState);
 		return -1;
@@ -338,7 +353,9 @@ int32_t LuaScriptInterface::loadFile(const std::string& file, Npc* npc /* = null
 	env->setNpc(npc);
 
 	//execute it
+	auto start = std::chrono::steady_clock::now();
 	ret = protectedCall(luaState, 0, 0);
+	LuaBytecodeCache::getInstance().addExecuteTime(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
 	if (ret != 0) {
 		reportError(nullptr, popString(luaState));
 		resetScriptEnv();
@@ -710,10 +727,146 @@ int32_t LuaScriptInterface::popCallback(lua_State* L)
 	return luaL_ref(L, LUA_REGISTRYINDEX);
 }
 
+// Userdata
+void LuaScriptInterface::pushCachedUserdata(lua_State* L, void* value)
+{
+	lua_rawgeti(L, LUA_REGISTRYINDEX, userdataCacheRef);
+	lua_pushlightuserdata(L, value);
+	lua_rawget(L, -2);
+
+	// scripts may have replaced or cleared the pointer (item:transform, creature:remove)
+	void** userdata = static_cast<void**>(lua_touserdata(L, -1));
+	if (userdata && *userdata == value) {
+		lua_remove(L, -2);
+		return;
+	}
+	lua_pop(L, 1);
+
+	userdata = static_cast<void**>(lua_newuserdata(L, sizeof(void*)));
+	*userdata = value;
+
+	lua_pushlightuserdata(L, value);
+	lua_pushvalue(L, -2);
+	lua_rawset(L, -4);
+	lua_remove(L, -2);
+}
+
+template<>
+void LuaScriptInterface::pushUserdata<Creature>(lua_State* L, Creature* value)
+{
+	if (value) {
+		value->setLuaUserdata();
+	}
+	pushCachedUserdata(L, value);
+}
+
+template<>
+void LuaScriptInterface::pushUserdata<Player>(lua_State* L, Player* value)
+{
+	if (value) {
+		value->setLuaUserdata();
+	}
+	pushCachedUserdata(L, value);
+}
+
+template<>
+void LuaScriptInterface::pushUserdata<Monster>(lua_State* L, Monster* value)
+{
+	if (value) {
+		value->setLuaUserdata();
+	}
+	pushCachedUserdata(L, value);
+}
+
+template<>
+void LuaScriptInterface::pushUserdata<Npc>(lua_State* L, Npc* value)
+{
+	if (value) {
+		value->setLuaUserdata();
+	}
+	pushCachedUserdata(L, value);
+}
+
+template<>
+void LuaScriptInterface::pushUserdata<Item>(lua_State* L, Item* value)
+{
+	if (value) {
+		value->setLuaUserdata();
+	}
+	pushCachedUserdata(L, value);
+}
+
+template<>
+void LuaScriptInterface::pushUserdata<Container>(lua_State* L, Container* value)
+{
+	if (value) {
+		value->setLuaUserdata();
+	}
+	pushCachedUserdata(L, value);
+}
+
+void LuaScriptInterface::removeCachedUserdata(lua_State* L, void* value)
+{
+	lua_rawgeti(L, LUA_REGISTRYINDEX, userdataCacheRef);
+	lua_pushlightuserdata(L, value);
+	lua_pushnil(L);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
 // Metatables
+void LuaScriptInterface::replaceMetatable(lua_State* L, int32_t index)
+{
+	// cached userdata is shared by every push of an object, a base class
+	// (a Player pushed as Creature) must not take away its derived methods
+	if (lua_getmetatable(L, index - 1)) {
+		lua_rawgeti(L, -1, 'p');
+		lua_rawgeti(L, -3, 'p');
+		int32_t depth = lua_tointeger(L, -2) - lua_tointeger(L, -1);
+		lua_pop(L, 2);
+
+		bool derived = false;
+		if (depth > 0) {
+			// walk the current class methods up to the depth of the new class
+			lua_pushstring(L, "__index");
+			lua_rawget(L, -2);
+			for (; depth > 0 && lua_getmetatable(L, -1); --depth) {
+				lua_pushstring(L, "__index");
+				lua_rawget(L, -2);
+				lua_remove(L, -2);
+				lua_remove(L, -2);
+			}
+
+			lua_pushstring(L, "__index");
+			lua_rawget(L, -4);
+			derived = depth == 0 && lua_rawequal(L, -1, -2);
+			lua_pop(L, 2);
+		}
+		lua_pop(L, 1);
+
+		if (derived) {
+			lua_pop(L, 1);
+			return;
+		}
+	}
+	lua_setmetatable(L, index - 1);
+}
+
 void LuaScriptInterface::setMetatable(lua_State* L, int32_t index, const std::string& name)
 {
-	luaL_getmetatable(L, name.c_str());
+	auto it = metatableRefs.find(name);
+	if (it != metatableRefs.end()) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, it->second);
+	} else {
+		luaL_getmetatable(L, name.c_str());
+	}
+	replaceMetatable(L, index);
+}
+
+void LuaScriptInterface::setMetatable(lua_State* L, int32_t index, LuaDataType type)
+{
+	// the exact class of the object, replaces whatever an earlier push set
+	lua_rawgeti(L, LUA_REGISTRYINDEX, dataTypeMetatableRefs[type]);
 	lua_setmetatable(L, index - 1);
 }
 
@@ -756,29 +909,27 @@ void LuaScriptInterface::setWeakMetatable(lua_State* L, int32_t index, const std
 void LuaScriptInterface::setItemMetatable(lua_State* L, int32_t index, const Item* item)
 {
 	if (item->getContainer()) {
-		luaL_getmetatable(L, "Container");
+		setMetatable(L, index, LuaData_Container);
 	}
 	else if (item->getTeleport()) {
-		luaL_getmetatable(L, "Teleport");
+		setMetatable(L, index, LuaData_Teleport);
 	}
 	else {
-		luaL_getmetatable(L, "Item");
+		setMetatable(L, index, LuaData_Item);
 	}
-	lua_setmetatable(L, index - 1);
 }
 
 void LuaScriptInterface::setCreatureMetatable(lua_State* L, int32_t index, const Creature* creature)
 {
 	if (creature->getPlayer()) {
-		luaL_getmetatable(L, "Player");
+		setMetatable(L, index, LuaData_Player);
 	}
 	else if (creature->getMonster()) {
-		luaL_getmetatable(L, "Monster");
+		setMetatable(L, index, LuaData_Monster);
 	}
 	else {
-		luaL_getmetatable(L, "Npc");
+		setMetatable(L, index, LuaData_Npc);
 	}
-	lua_setmetatable(L, index - 1);
 }
 
 CombatDamage LuaScriptInterface::getCombatDamage(lua_State* L)
@@ -2898,6 +3049,8 @@ void LuaScriptInterface::registerFunctions()
 	registerMethod("Game", "getClientVersion", LuaScriptInterface::luaGameGetClientVersion);
 
 	registerMethod("Game", "reload", LuaScriptInterface::luaGameReload);
+	registerMethod("Game", "setLuaProfiler", LuaScriptInterface::luaGameSetLuaProfiler);
+	registerMethod("Game", "benchmarkBindings", LuaScriptInterface::luaGameBenchmarkBindings);
 
 	registerMethod("Game", "getItemIdByClientId", LuaScriptInterface::luaGameGetItemByClientId);
 
@@ -4253,8 +4406,17 @@ void LuaScriptInterface::registerClass(const std::string& className, const std::
 	else {
 		lua_pushnumber(luaState, LuaData_Unknown);
 	}
+	LuaDataType type = getNumber<LuaDataType>(luaState, -1);
 	lua_rawseti(luaState, metatable, 't');
 
+	// registry reference to className.metatable, used instead of looking it up by name
+	lua_pushvalue(luaState, metatable);
+	int metatableRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+	metatableRefs[className] = metatableRef;
+	if (type != LuaData_Unknown) {
+		dataTypeMetatableRefs[type] = metatableRef;
+	}
+
 	// pop className, className.metatable
 	lua_pop(luaState, 2);
 }
@@ -5804,18 +5966,40 @@ int LuaScriptInterface::luaGameGetPlayers(lua_State* L)
 
 int LuaScriptInterface::luaGameLoadMap(lua_State* L)
 {
-	// Game.loadMap(path)
+	// Game.loadMap(path[, callback])
+	// parsed in the background, the tiles show up over the next dispatcher cycles
+	// and callback(loaded) runs once the last one is placed
 	const std::string& path = getString(L, 1);
-	g_dispatcher.addTask(createOldTask([path]() {
-		try {
-			g_game.loadMap(path);
-		}
-		catch (const std::exception& e) {
-			// FIXME: Should only catch some exceptions
-			SPDLOG_ERROR("[LuaScriptInterface::luaGameLoadMap] - Failed to load map: {}",
-				e.what());
+	lua_State* globalState = g_luaEnvironment.getLuaState();
+	if (!isFunction(L, 2) || !globalState) {
+		g_game.loadMap(path);
+		return 0;
+	}
+
+	// kept as a timer event without a timer, so a script reload drops it like any other
+	lua_pushvalue(L, 2);
+	if (globalState != L) {
+		lua_xmove(L, globalState, 1);
+	}
+
+	LuaTimerEventDesc eventDesc;
+	eventDesc.scriptId = getScriptEnv()->getScriptId();
+	eventDesc.function = luaL_ref(globalState, LUA_REGISTRYINDEX);
+
+	uint32_t eventId = g_luaEnvironment.lastEventTimerId++;
+	g_luaEnvironment.timerEvents.emplace(eventId, std::move(eventDesc));
+
+	g_game.loadMap(path, [eventId](bool loaded) {
+		auto it = g_luaEnvironment.timerEvents.find(eventId);
+		if (it == g_luaEnvironment.timerEvents.end()) {
+			return;
 		}
-		}));
+
+		lua_State* state = g_luaEnvironment.getLuaState();
+		pushBoolean(state, loaded);
+		it->second.parameters.push_back(luaL_ref(state, LUA_REGISTRYINDEX));
+		g_luaEnvironment.executeTimerEvent(eventId);
+	});
 	return 0;
 }
 
@@ -6271,6 +6455,41 @@ int LuaScriptInterface::luaGameReload(lua_State* L)
 	return 1;
 }
 
+int LuaScriptInterface::luaGameSetLuaProfiler(lua_State* L)
+{
+	// Game.setLuaProfiler(enabled)
+	LuaProfiler& profiler = LuaProfiler::getInstance();
+	lua_State* state = g_luaEnvironment.getLuaState();
+	if (getBoolean(L, 1)) {
+		profiler.start(state);
+		pushBoolean(L, true);
+	} else if (profiler.isRunning()) {
+		const std::string& fileName = profiler.stop(state);
+		if (fileName.empty()) {
+			pushBoolean(L, false);
+		} else {
+			pushString(L, fileName);
+		}
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
+int LuaScriptInterface::luaGameBenchmarkBindings(lua_State* L)
+{
+	// Game.benchmarkBindings([iterations = 100000])
+	uint32_t iterations = getNumber<uint32_t>(L, 1, 100000);
+	if (iterations == 0) {
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	g_luaEnvironment.benchmarkBindings(iterations);
+	pushBoolean(L, true);
+	return 1;
+}
+
 int LuaScriptInterface::luaGameItemidHasMoveevent(lua_State* L)
 {
 	// Game.itemidHasMoveevent(itemid)
@@ -22513,6 +22732,15 @@ bool LuaEnvironment::initState()
 	}
 
 	luaL_openlibs(luaState);
+
+	// userdata cache of game objects, weak valued so unused entries are collected
+	lua_newtable(luaState);
+	lua_createtable(luaState, 0, 1);
+	pushString(luaState, "v");
+	lua_setfield(luaState, -2, "__mode");
+	lua_setmetatable(luaState, -2);
+	userdataCacheRef = luaL_ref(luaState, LUA_REGISTRYINDEX);
+
 	registerFunctions();
 
 	runningEventId = EVENT_ID_USER;
@@ -22567,6 +22795,81 @@ LuaScriptInterface* LuaEnvironment::getTestInterface()
 	return testInterface;
 }
 
+void LuaEnvironment::benchmarkBindings(uint32_t iterations)
+{
+	LuaScriptInterface* interface = getTestInterface();
+	interface->reInitState();
+	lua_State* L = interface->getLuaState();
+	if (!L) {
+		return;
+	}
+
+	Item* item = Item::CreateItem(ITEM_GOLD_COIN);
+	Item* container = Item::CreateItem(ITEM_BAG);
+	if (!item || !container) {
+		delete item;
+		delete container;
+		SPDLOG_ERROR("[LuaEnvironment::benchmarkBindings] - Can't create the items to push");
+		return;
+	}
+
+	// the collector is stopped while timing, so the count grows by what a case allocated
+	auto run = [L, iterations](const std::string& name, const std::function<bool()>& body) {
+		lua_gc(L, LUA_GCCOLLECT, 0);
+		lua_gc(L, LUA_GCSTOP, 0);
+		int kilobytes = lua_gc(L, LUA_GCCOUNT, 0);
+		auto start = std::chrono::steady_clock::now();
+		bool success = body();
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		int allocated = lua_gc(L, LUA_GCCOUNT, 0) - kilobytes;
+		lua_gc(L, LUA_GCRESTART, 0);
+
+		if (success) {
+			SPDLOG_INFO("[LuaEnvironment::benchmarkBindings] - {}: {} ns per call, {} KB allocated",
+                        name, elapsed / iterations, allocated);
+		}
+	};
+
+	run("push item", [L, item, iterations]() {
+		for (uint32_t i = 0; i < iterations; ++i) {
+			pushUserdata<Item>(L, item);
+			setItemMetatable(L, -1, item);
+			lua_pop(L, 1);
+		}
+		return true;
+	});
+
+	run("push container", [L, container, iterations]() {
+		for (uint32_t i = 0; i < iterations; ++i) {
+			pushUserdata<Item>(L, container);
+			setItemMetatable(L, -1, container);
+			lua_pop(L, 1);
+		}
+		return true;
+	});
+
+	// a method call from a script, through the binding trampoline
+	run("item:getId()", [L, item, iterations]() {
+		if (luaL_loadstring(L, "local item, n = ... for i = 1, n do item:getId() end") != 0) {
+			SPDLOG_ERROR("[LuaEnvironment::benchmarkBindings] - {}", popString(L));
+			return false;
+		}
+
+		pushUserdata<Item>(L, item);
+		setItemMetatable(L, -1, item);
+		lua_pushnumber(L, iterations);
+		if (lua_pcall(L, 2, 0, 0) != 0) {
+			SPDLOG_ERROR("[LuaEnvironment::benchmarkBindings] - {}", popString(L));
+			return false;
+		}
+		return true;
+	});
+
+	delete item;
+	delete container;
+	lua_gc(L, LUA_GCCOLLECT, 0);
+}
+
 Combat* LuaEnvironment::getCombatObject(uint32_t id) const
 {
 	auto it = combatMap.find(id);
@@ -50,6 +50,7 @@ class AreaCombat;
 class Combat;
 class Condition;
 class Npc;
+class Tile;
 class Monster;
 class InstantSpell;
 
@@ -282,9 +283,13 @@ class LuaScriptInterface
 			T** userdata = static_cast<T**>(lua_newuserdata(L, sizeof(T*)));
 			*userdata = value;
 		}
+		// game objects reuse the userdata still alive from an earlier push
+		static void pushCachedUserdata(lua_State* L, void* value);
+		static void removeCachedUserdata(lua_State* L, void* value);
 
 		// Metatables
 		static void setMetatable(lua_State* L, int32_t index, const std::string& name);
+		static void setMetatable(lua_State* L, int32_t index, LuaDataType type);
 		static void setWeakMetatable(lua_State* L, int32_t index, const std::string& name);
 
 		static void setItemMetatable(lua_State* L, int32_t index, const Item* item);
@@ -450,6 +455,8 @@ class LuaScriptInterface
 		std::string getStackTrace(const std::string& error_desc);
 
 		static bool getArea(lua_State* L, std::list<uint32_t>& list, uint32_t& rows);
+		// sets the metatable on top of the stack unless the userdata carries a derived one
+		static void replaceMetatable(lua_State* L, int32_t index);
 
 		//lua functions
 		static int luaDoPlayerAddItem(lua_State* L);
@@ -597,6 +604,8 @@ class LuaScriptInterface
 		static int luaGameGetClientVersion(lua_State* L);
 
 		static int luaGameReload(lua_State* L);
+		static int luaGameSetLuaProfiler(lua_State* L);
+		static int luaGameBenchmarkBindings(lua_State* L);
 
 		static int luaGameGetItemByClientId(lua_State* L);
 		static int luaGameGetOfflinePlayer(lua_State* L);
@@ -1806,8 +1815,33 @@ class LuaScriptInterface
 		static int32_t scriptEnvIndex;
 
 		std::string loadingFile;
+
+	protected:
+		// registry references resolved when the classes are registered
+		static std::unordered_map<std::string, int> metatableRefs;
+		static std::array<int, LuaData_Tile + 1> dataTypeMetatableRefs;
+		static int userdataCacheRef;
 };
 
+// defined with the game types, they mark the object as known to scripts
+template<>
+void LuaScriptInterface::pushUserdata<Creature>(lua_State* L, Creature* value);
+template<>
+void LuaScriptInterface::pushUserdata<Player>(lua_State* L, Player* value);
+template<>
+void LuaScriptInterface::pushUserdata<Monster>(lua_State* L, Monster* value);
+template<>
+void LuaScriptInterface::pushUserdata<Npc>(lua_State* L, Npc* value);
+template<>
+void LuaScriptInterface::pushUserdata<Item>(lua_State* L, Item* value);
+template<>
+void LuaScriptInterface::pushUserdata<Container>(lua_State* L, Container* value);
+template<>
+inline void LuaScriptInterface::pushUserdata<Tile>(lua_State* L, Tile* value)
+{
+	pushCachedUserdata(L, value);
+}
+
 class LuaEnvironment : public LuaScriptInterface
 {
 	public:
@@ -1823,6 +1857,8 @@ class LuaEnvironment : public LuaScriptInterface
 		bool closeState() override;
 
 		LuaScriptInterface* getTestInterface();
+		// times the object bindings on the test interface and logs the results
+		void benchmarkBindings(uint32_t iterations);
 
 		Combat* getCombatObject(uint32_t id) const;
 		Combat* createCombatObject(LuaScriptInterface* interface);
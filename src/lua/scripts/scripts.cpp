@@ -28,6 +28,7 @@
 #include "lua/global/globalevent.h"
 #include "lua/creature/events.h"
 #include "lua/scripts/scripts.h"
+#include "lua/scripts/luabytecodecache.h"
 #include "lua/modules/modules.h"
 #include "creatures/players/imbuements/imbuements.h"
 #include <boost/filesystem.hpp>
@@ -168,6 +169,18 @@ bool Scripts::loadScripts(std::string folderName, bool isLib, bool reload)
 		}
 	}
 	sort(v.begin(), v.end());
+
+	LuaBytecodeCache& bytecodeCache = LuaBytecodeCache::getInstance();
+	bytecodeCache.resetStats();
+	if (g_config.getNumber(ConfigManager::LUA_PRECOMPILE_THREADS) > 0) {
+		std::vector<std::string> files;
+		files.reserve(v.size());
+		for (const fs::path& path : v) {
+			files.push_back(path.string());
+		}
+		bytecodeCache.precompile(files);
+	}
+
 	std::string redir;
 	for (auto it = v.begin(); it != v.end(); ++it) {
 		const std::string scriptFile = it->string();
@@ -196,5 +209,10 @@ bool Scripts::loadScripts(std::string folderName, bool isLib, bool reload)
 		}
 	}
 
+	LuaBytecodeCache::LoadStats stats = bytecodeCache.resetStats();
+	if (g_config.getBoolean(ConfigManager::LUA_BYTECODE_CACHE)) {
+		SPDLOG_INFO("Loaded {} in parse {} ms / execute {} ms (bytecode cache hits {}/{})", folderName,
+		                stats.parseTime / 1000, stats.executeTime / 1000, stats.hits, stats.hits + stats.misses);
+	}
 	return true;
 }
@@ -434,7 +434,11 @@ void Map::getSpectators(SpectatorHashSet& spectators, const Position& centerPos,
 		}
 	}
 
-	if (!foundCache) {
+	if (foundCache) {
+		g_metrics.add(METRIC_SPECTATOR_CACHE_HITS);
+	} else {
+		auto start = std::chrono::high_resolution_clock::now();
+		TraceSpan span("getSpectators");
 		int32_t minRangeZ;
 		int32_t maxRangeZ;
 
@@ -469,6 +473,7 @@ void Map::getSpectators(SpectatorHashSet& spectators, const Position& centerPos,
 				spectatorCache[centerPos] = spectators;
 			}
 		}
+		g_metrics.record(METRIC_SPECTATOR_QUERY, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count());
 	}
 }
 
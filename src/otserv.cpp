@@ -27,6 +27,7 @@
 #include "pathfinding.h"
 #include "lua/creature/events.h"
 #include "game/game.h"
+#include "io/iohighscores.h"
 #include "io/iomarket.h"
 #include "lua/modules/modules.h"
 #include "server/network/protocol/protocollogin.h"
@@ -49,6 +50,7 @@ DatabaseTasks g_databaseTasks;
 Dispatcher g_dispatcher;
 Scheduler g_scheduler;
 Stats g_stats;
+Metrics g_metrics;
 PathFinding g_pathfinding(PATHFINDING_THREADS);
 
 Game g_game;
@@ -226,6 +228,7 @@ int main(int argc, char* argv[]) {
 	g_databaseTasks.join();
 	g_dispatcher.join();
 	g_stats.join();
+	webhook_shutdown();
 	return 0;
 }
 #endif
@@ -340,6 +343,8 @@ void mainLoader(int, char*[], ServiceManager* services) {
 	// OT protocols
 	services->add<ProtocolStatus>(static_cast<uint16_t>(g_config.getNumber(
 												ConfigManager::STATUS_PORT)));
+	g_stats.setMetricsPort(static_cast<uint16_t>(g_config.getNumber(
+												ConfigManager::METRICS_PORT)));
 
 	RentPeriod_t rentPeriod;
 	std::string strRentPeriod = asLowerCaseString(g_config.getString(
@@ -363,6 +368,8 @@ void mainLoader(int, char*[], ServiceManager* services) {
 	IOMarket::getInstance().updateStatistics();
 	g_game.checkMarketStatistics();
 
+	IOHighscores::getInstance().load();
+
 	SPDLOG_INFO("Loaded all modules, server starting up...");
 
 #ifndef _WIN32
@@ -376,6 +383,8 @@ void mainLoader(int, char*[], ServiceManager* services) {
 	g_game.start(services);
 	g_game.setGameState(GAME_STATE_NORMAL);
 
+	ProtocolStatus::checkStatusSnapshot();
+
 	webhook_init();
 	webhook_send_message("Server is now online", "Server has successfully started.", WEBHOOK_COLOR_ONLINE);
 
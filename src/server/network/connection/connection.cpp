@@ -240,6 +240,9 @@ void Connection::parsePacket(const boost::system::error_code& error)
 		return;
 	}
 
+	g_metrics.add(METRIC_PACKETS_IN);
+	g_metrics.add(METRIC_BYTES_IN, NetworkMessage::HEADER_LENGTH + msg.getLength());
+
 	//Check packet
 	uint32_t recvPacket = msg.get<uint32_t>();
 	if ((recvPacket & 1 << 31) != 0) {
@@ -303,6 +306,8 @@ void Connection::send(const OutputMessage_ptr& conMsg)
 void Connection::internalSend(const OutputMessage_ptr& conMsg)
 {
 	protocol->onSendMessage(conMsg);
+	g_metrics.add(METRIC_PACKETS_OUT);
+	g_metrics.add(METRIC_BYTES_OUT, conMsg->getLength());
 	try {
 		writeTimer.expires_from_now(boost::posix_time::seconds(CONNECTION_WRITE_TIMEOUT));
 		writeTimer.async_wait(std::bind(&Connection::handleTimeout, std::weak_ptr<Connection>(shared_from_this()),
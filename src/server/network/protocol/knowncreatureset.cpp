@@ -0,0 +1,91 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "otpch.h"
+
+#include "server/network/protocol/knowncreatureset.h"
+
+size_t KnownCreatureSet::findSlot(uint32_t id) const
+{
+	for (size_t slot = homeSlot(id); slots[slot].id != 0; slot = (slot + 1) & SLOT_MASK) {
+		if (slots[slot].id == id) {
+			return slot;
+		}
+	}
+	return NOT_FOUND;
+}
+
+bool KnownCreatureSet::touch(uint32_t id)
+{
+	size_t slot = findSlot(id);
+	if (slot == NOT_FOUND) {
+		return false;
+	}
+
+	entries[slots[slot].entry].seen = true;
+	return true;
+}
+
+void KnownCreatureSet::insert(uint32_t id)
+{
+	size_t index = freeEntry;
+	if (index != CAPACITY) {
+		freeEntry = CAPACITY;
+	} else {
+		index = count;
+	}
+	++count;
+
+	entries[index].id = id;
+	entries[index].seen = true;
+
+	size_t slot = homeSlot(id);
+	while (slots[slot].id != 0) {
+		slot = (slot + 1) & SLOT_MASK;
+	}
+	slots[slot].id = id;
+	slots[slot].entry = static_cast<uint16_t>(index);
+}
+
+void KnownCreatureSet::eraseSlot(size_t slot)
+{
+	// shift the rest of the probe run back instead of leaving a tombstone
+	size_t hole = slot;
+	for (size_t next = (hole + 1) & SLOT_MASK; slots[next].id != 0; next = (next + 1) & SLOT_MASK) {
+		size_t home = homeSlot(slots[next].id);
+		if (((next - home) & SLOT_MASK) >= ((next - hole) & SLOT_MASK)) {
+			slots[hole] = slots[next];
+			hole = next;
+		}
+	}
+	slots[hole].id = 0;
+}
+
+uint32_t KnownCreatureSet::removeEntry(size_t index)
+{
+	uint32_t id = entries[index].id;
+	eraseSlot(findSlot(id));
+
+	// only evict frees entries and insert always follows it, so the set
+	// stays dense and the clock keeps walking over all of it
+	freeEntry = index;
+	--count;
+	return id;
+}
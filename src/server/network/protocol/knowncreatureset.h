@@ -0,0 +1,110 @@
+/**
+ * The Forgotten Server - a free and open-source MMORPG server emulator
+ * Copyright (C) 2019  Mark Samman <mark.samman@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef FS_KNOWNCREATURESET_H_7B2E9D4A1C6F4E3B8A5D0C9E2F7B1A64
+#define FS_KNOWNCREATURESET_H_7B2E9D4A1C6F4E3B8A5D0C9E2F7B1A64
+
+/**
+ * Creatures the client holds in its own creature list, sent by id only.
+ * The client keeps at most CAPACITY of them, so once full every new creature
+ * replaces one. Entries are evicted in clock order: a creature seen again
+ * since the hand last passed over it gets a second chance, so the ones
+ * long out of sight are found in a few steps instead of scanning the set.
+ */
+class KnownCreatureSet
+{
+	public:
+		static constexpr size_t CAPACITY = 1300;
+
+		bool contains(uint32_t id) const {
+			return findSlot(id) != NOT_FOUND;
+		}
+
+		// Marks the creature as just seen, returns false when it is not known
+		bool touch(uint32_t id);
+
+		bool full() const {
+			return count == CAPACITY;
+		}
+
+		size_t size() const {
+			return count;
+		}
+
+		// The set must not be full
+		void insert(uint32_t id);
+
+		// Only used on a full set: removes the first entry in clock order
+		// accepted by canEvict, or the entry under the hand when none is.
+		// Returns the removed id.
+		template <typename Predicate>
+		uint32_t evict(Predicate&& canEvict) {
+			// the first lap may only clear the seen marks
+			for (size_t step = 0; step < 2 * count; ++step) {
+				size_t index = advanceHand();
+				if (entries[index].seen) {
+					entries[index].seen = false;
+				} else if (canEvict(entries[index].id)) {
+					return removeEntry(index);
+				}
+			}
+			return removeEntry(advanceHand());
+		}
+
+	private:
+		static constexpr size_t SLOTS = 2048;
+		static constexpr size_t SLOT_MASK = SLOTS - 1;
+		static constexpr size_t NOT_FOUND = SLOTS;
+		static_assert((SLOTS & SLOT_MASK) == 0 && SLOTS > CAPACITY, "slot table must be a power of two larger than the capacity");
+
+		// open addressing with linear probing, id 0 marks an empty slot
+		struct Slot {
+			uint32_t id = 0;
+			uint16_t entry = 0;
+		};
+
+		struct Entry {
+			uint32_t id = 0;
+			bool seen = false;
+		};
+
+		static size_t homeSlot(uint32_t id) {
+			return (id * 0x9E3779B1U) >> 21;
+		}
+
+		size_t findSlot(uint32_t id) const;
+		void eraseSlot(size_t slot);
+		uint32_t removeEntry(size_t index);
+
+		size_t advanceHand() {
+			size_t index = hand;
+			hand = (hand + 1) % count;
+			return index;
+		}
+
+		Slot slots[SLOTS];
+		Entry entries[CAPACITY];
+		size_t count = 0;
+		size_t hand = 0;
+		// entry left by evict, reused by the next insert
+		size_t freeEntry = CAPACITY;
+};
+
+#endif
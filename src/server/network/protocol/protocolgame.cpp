@@ -990,45 +990,27 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 
 void ProtocolGame::checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown)
 {
-	auto result = knownCreatureSet.insert(id);
-	if (!result.second)
+	if (knownCreatureSet.touch(id))
 	{
 		known = true;
 		return;
 	}
 
 	known = false;
+	removedKnown = 0;
 
-	if (knownCreatureSet.size() > 1300) {
-		// Look for a creature to remove
-		for (auto it = knownCreatureSet.begin(), end = knownCreatureSet.end(); it != end; ++it) {
+	if (knownCreatureSet.full()) {
+		removedKnown = knownCreatureSet.evict([this](uint32_t knownId) {
 			// We need to protect party players from removing
-			Creature* creature = g_game.getCreatureByID(*it);
+			Creature* creature = g_game.getCreatureByID(knownId);
 			Player* checkPlayer;
-			if (creature && (checkPlayer = creature->getPlayer()) != nullptr) {
-				if (player->getParty() != checkPlayer->getParty() && !canSee(creature) && id != *it) {
-					removedKnown = *it;
-					knownCreatureSet.erase(it);
-					return;
-				}
-			} else if (!canSee(creature)&& id != *it) {
-				removedKnown = *it;
-				knownCreatureSet.erase(it);
-				return;
+			if (creature && (checkPlayer = creature->getPlayer()) != nullptr && player->getParty() == checkPlayer->getParty()) {
+				return false;
 			}
-		}
-
-		// Bad situation. Let's just remove anyone.
-		auto it = knownCreatureSet.begin();
-		if (*it == id) {
-			++it;
-		}
-
-		removedKnown = *it;
-		knownCreatureSet.erase(it);
-	} else {
-		removedKnown = 0;
+			return !canSee(creature);
+		});
 	}
+	knownCreatureSet.insert(id);
 }
 
 bool ProtocolGame::canSee(const Creature *c) const
@@ -5078,6 +5060,12 @@ void ProtocolGame::sendCreatureSay(const Creature *creature, SpeakClasses type,
 void ProtocolGame::sendToChannel(const Creature *creature, SpeakClasses type, const std::string &text, uint16_t channelId)
 {
 	NetworkMessage msg;
+	addChannelMessage(msg, creature, type, text, channelId);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::addChannelMessage(NetworkMessage &msg, const Creature *creature, SpeakClasses type, const std::string &text, uint16_t channelId)
+{
 	msg.addByte(0xAA);
 
 	static uint32_t statementId = 0;
@@ -5121,7 +5109,6 @@ void ProtocolGame::sendToChannel(const Creature *creature, SpeakClasses type, co
 	msg.addByte(type);
 	msg.add<uint16_t>(channelId);
 	msg.addString(text);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendPrivateMessage(const Player *speaker, SpeakClasses type, const std::string &text)
@@ -5328,7 +5315,7 @@ void ProtocolGame::sendPartyCreatureUpdate(const Creature* target)
 void ProtocolGame::sendPartyCreatureShield(const Creature* target)
 {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatureSet.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -5347,7 +5334,7 @@ void ProtocolGame::sendPartyCreatureSkull(const Creature* target)
 	}
 
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatureSet.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -5362,7 +5349,7 @@ void ProtocolGame::sendPartyCreatureSkull(const Creature* target)
 void ProtocolGame::sendPartyCreatureHealth(const Creature* target, uint8_t healthPercent)
 {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatureSet.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -5377,7 +5364,7 @@ void ProtocolGame::sendPartyCreatureHealth(const Creature* target, uint8_t healt
 void ProtocolGame::sendPartyPlayerMana(const Player* target, uint8_t manaPercent)
 {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatureSet.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 	}
 
@@ -5392,7 +5379,7 @@ void ProtocolGame::sendPartyPlayerMana(const Player* target, uint8_t manaPercent
 void ProtocolGame::sendPartyCreatureShowStatus(const Creature* target, bool showStatus)
 {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatureSet.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 	}
 
@@ -5407,7 +5394,7 @@ void ProtocolGame::sendPartyCreatureShowStatus(const Creature* target, bool show
 void ProtocolGame::sendPartyPlayerVocation(const Player* target)
 {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatureSet.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -7437,8 +7424,7 @@ void ProtocolGame::reloadCreature(const Creature *creature)
 
 	NetworkMessage msg;
 
-	std::unordered_set<uint32_t>::iterator it = std::find(knownCreatureSet.begin(), knownCreatureSet.end(), creature->getID());
-	if (it != knownCreatureSet.end())
+	if (knownCreatureSet.contains(creature->getID()))
 	{
 		msg.addByte(0x6B);
 		msg.addPosition(creature->getPosition());
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "server/network/protocol/protocol.h"
+#include "server/network/protocol/knowncreatureset.h"
 #include "creatures/interactions/chat.h"
 #include "config/configmanager.h"
 #include "creatures/creature.h"
@@ -101,6 +102,10 @@ public:
 		return version;
 	}
 
+	// channel messages do not depend on the receiver, so a channel encodes
+	// them once and hands the same bytes to every listener
+	static void addChannelMessage(NetworkMessage &msg, const Creature *creature, SpeakClasses type, const std::string &text, uint16_t channelId);
+
 private:
 	ProtocolGame_ptr getThis()
 	{
@@ -501,7 +506,7 @@ private:
 	void addNewGameTaskTimed(uint32_t delay, Callable function, const std::string& function_str, const std::string& extra_info, Args&&... args) {
 		g_dispatcher.addTask(createNewTask(delay, std::bind(function, &g_game, std::forward<Args>(args)...), function_str, extra_info));
 	}
-	std::unordered_set<uint32_t> knownCreatureSet;
+	KnownCreatureSet knownCreatureSet;
 	Player *player = nullptr;
 
 	uint32_t eventConnect = 0;
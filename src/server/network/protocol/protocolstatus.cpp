@@ -24,14 +24,21 @@
 #include "server/network/protocol/protocolstatus.h"
 #include "config/configmanager.h"
 #include "game/game.h"
+#include "game/scheduling/scheduler.h"
 #include "server/network/message/outputmessage.h"
 
 extern ConfigManager g_config;
 extern Game g_game;
 
 std::map<uint32_t, int64_t> ProtocolStatus::ipConnectMap;
+StatusSnapshot_ptr ProtocolStatus::statusSnapshot;
 const uint64_t ProtocolStatus::start = OTSYS_TIME();
 
+static constexpr int32_t STATUS_SNAPSHOT_CHECK_INTERVAL = 1000;
+static constexpr int64_t STATUS_SNAPSHOT_MAX_AGE = 5000;
+// uptime is the first attribute written, so the first match is always the placeholder
+static constexpr char STATUS_UPTIME_PLACEHOLDER[] = "{uptime}";
+
 enum RequestedInfo_t : uint16_t {
 	REQUEST_BASIC_SERVER_INFO = 1 << 0,
 	REQUEST_OWNER_SERVER_INFO = 1 << 1,
@@ -59,12 +66,17 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage& msg)
 
 	ipConnectMap[ip] = OTSYS_TIME();
 
+	StatusSnapshot_ptr snapshot = getStatusSnapshot();
+	if (!snapshot) {
+		disconnect();
+		return;
+	}
+
 	switch (msg.getByte()) {
 		//XML info protocol
 		case 0xFF: {
 			if (msg.getString(4) == "info") {
-				g_dispatcher.addTask(createTask(std::bind(&ProtocolStatus::sendStatusString,
-									  std::static_pointer_cast<ProtocolStatus>(shared_from_this()))));
+				sendStatusString(snapshot);
 				return;
 			}
 			break;
@@ -77,8 +89,7 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage& msg)
 			if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
 				characterName = msg.getString();
 			}
-			g_dispatcher.addTask(createTask(std::bind(&ProtocolStatus::sendInfo, std::static_pointer_cast<ProtocolStatus>(shared_from_this()),
-								  requestedInfo, characterName)));
+			sendInfo(snapshot, requestedInfo, characterName);
 			return;
 		}
 
@@ -88,11 +99,50 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage& msg)
 	disconnect();
 }
 
-void ProtocolStatus::sendStatusString()
+void ProtocolStatus::checkStatusSnapshot()
 {
-	auto output = OutputMessagePool::getOutputMessage();
+	StatusSnapshot_ptr snapshot = getStatusSnapshot();
+	if (!snapshot || snapshot->playersOnline != g_game.getPlayersOnline()
+			|| OTSYS_TIME() - snapshot->createdAt >= STATUS_SNAPSHOT_MAX_AGE) {
+		updateStatusSnapshot();
+	}
 
-	setRawMessages(true);
+	g_scheduler.addEvent(createSchedulerTask(STATUS_SNAPSHOT_CHECK_INTERVAL, &ProtocolStatus::checkStatusSnapshot));
+}
+
+void ProtocolStatus::updateStatusSnapshot()
+{
+	auto snapshot = std::make_shared<StatusSnapshot>();
+	snapshot->createdAt = OTSYS_TIME();
+
+	snapshot->serverName = g_config.getString(ConfigManager::SERVER_NAME);
+	snapshot->ip = g_config.getString(ConfigManager::IP);
+	snapshot->loginPort = std::to_string(g_config.getNumber(ConfigManager::LOGIN_PORT));
+	snapshot->ownerName = g_config.getString(ConfigManager::OWNER_NAME);
+	snapshot->ownerEmail = g_config.getString(ConfigManager::OWNER_EMAIL);
+	snapshot->motd = g_config.getString(ConfigManager::MOTD);
+	snapshot->location = g_config.getString(ConfigManager::LOCATION);
+	snapshot->url = g_config.getString(ConfigManager::URL);
+	snapshot->mapName = g_config.getString(ConfigManager::MAP_NAME);
+	snapshot->mapAuthor = g_config.getString(ConfigManager::MAP_AUTHOR);
+	snapshot->clientVersion = g_config.getString(ConfigManager::CLIENT_VERSION_STR);
+
+	snapshot->playersOnline = g_game.getPlayersOnline();
+	snapshot->maxPlayers = g_config.getNumber(ConfigManager::MAX_PLAYERS);
+	snapshot->playersRecord = g_game.getPlayersRecord();
+
+	uint32_t mapWidth, mapHeight;
+	g_game.getMapDimensions(mapWidth, mapHeight);
+	snapshot->mapWidth = mapWidth;
+	snapshot->mapHeight = mapHeight;
+
+	const auto& onlinePlayers = g_game.getPlayers();
+	snapshot->players.reserve(onlinePlayers.size());
+	snapshot->playerNames.reserve(onlinePlayers.size());
+	for (const auto& it : onlinePlayers) {
+		snapshot->players.emplace_back(it.second->getName(), it.second->getLevel());
+		snapshot->playerNames.insert(asLowerCaseString(it.second->getName()));
+	}
 
 	pugi::xml_document doc;
 
@@ -103,25 +153,24 @@ void ProtocolStatus::sendStatusString()
 	tsqp.append_attribute("version") = "1.0";
 
 	pugi::xml_node serverinfo = tsqp.append_child("serverinfo");
-	uint64_t uptime = (OTSYS_TIME() - ProtocolStatus::start) / 1000;
-	serverinfo.append_attribute("uptime") = std::to_string(uptime).c_str();
-	serverinfo.append_attribute("ip") = g_config.getString(ConfigManager::IP).c_str();
-	serverinfo.append_attribute("servername") = g_config.getString(ConfigManager::SERVER_NAME).c_str();
-	serverinfo.append_attribute("port") = std::to_string(g_config.getNumber(ConfigManager::LOGIN_PORT)).c_str();
-	serverinfo.append_attribute("location") = g_config.getString(ConfigManager::LOCATION).c_str();
-	serverinfo.append_attribute("url") = g_config.getString(ConfigManager::URL).c_str();
+	serverinfo.append_attribute("uptime") = STATUS_UPTIME_PLACEHOLDER;
+	serverinfo.append_attribute("ip") = snapshot->ip.c_str();
+	serverinfo.append_attribute("servername") = snapshot->serverName.c_str();
+	serverinfo.append_attribute("port") = snapshot->loginPort.c_str();
+	serverinfo.append_attribute("location") = snapshot->location.c_str();
+	serverinfo.append_attribute("url") = snapshot->url.c_str();
 	serverinfo.append_attribute("server") = STATUS_SERVER_NAME;
 	serverinfo.append_attribute("version") = STATUS_SERVER_VERSION;
-	serverinfo.append_attribute("client") = g_config.getString(ConfigManager::CLIENT_VERSION_STR).c_str();
+	serverinfo.append_attribute("client") = snapshot->clientVersion.c_str();
 
 	pugi::xml_node owner = tsqp.append_child("owner");
-	owner.append_attribute("name") = g_config.getString(ConfigManager::OWNER_NAME).c_str();
-	owner.append_attribute("email") = g_config.getString(ConfigManager::OWNER_EMAIL).c_str();
+	owner.append_attribute("name") = snapshot->ownerName.c_str();
+	owner.append_attribute("email") = snapshot->ownerEmail.c_str();
 
 	pugi::xml_node players = tsqp.append_child("players");
-	players.append_attribute("online") = std::to_string(g_game.getPlayersOnline()).c_str();
-	players.append_attribute("max") = std::to_string(g_config.getNumber(ConfigManager::MAX_PLAYERS)).c_str();
-	players.append_attribute("peak") = std::to_string(g_game.getPlayersRecord()).c_str();
+	players.append_attribute("online") = std::to_string(snapshot->playersOnline).c_str();
+	players.append_attribute("max") = std::to_string(snapshot->maxPlayers).c_str();
+	players.append_attribute("peak") = std::to_string(snapshot->playersRecord).c_str();
 
 	pugi::xml_node monsters = tsqp.append_child("monsters");
 	monsters.append_attribute("total") = std::to_string(g_game.getMonstersOnline()).c_str();
@@ -137,82 +186,92 @@ void ProtocolStatus::sendStatusString()
 	rates.append_attribute("spawn") = std::to_string(g_config.getNumber(ConfigManager::RATE_SPAWN)).c_str();
 
 	pugi::xml_node map = tsqp.append_child("map");
-	map.append_attribute("name") = g_config.getString(ConfigManager::MAP_NAME).c_str();
-	map.append_attribute("author") = g_config.getString(ConfigManager::MAP_AUTHOR).c_str();
-
-	uint32_t mapWidth, mapHeight;
-	g_game.getMapDimensions(mapWidth, mapHeight);
+	map.append_attribute("name") = snapshot->mapName.c_str();
+	map.append_attribute("author") = snapshot->mapAuthor.c_str();
 	map.append_attribute("width") = std::to_string(mapWidth).c_str();
 	map.append_attribute("height") = std::to_string(mapHeight).c_str();
 
 	pugi::xml_node motd = tsqp.append_child("motd");
-	motd.text() = g_config.getString(ConfigManager::MOTD).c_str();
+	motd.text() = snapshot->motd.c_str();
 
 	std::ostringstream ss;
 	doc.save(ss, "", pugi::format_raw);
 
 	std::string data = ss.str();
-	output->addBytes(data.c_str(), data.size());
+	size_t uptimePos = data.find(STATUS_UPTIME_PLACEHOLDER);
+	snapshot->xmlHead = data.substr(0, uptimePos);
+	snapshot->xmlTail = data.substr(uptimePos + sizeof(STATUS_UPTIME_PLACEHOLDER) - 1);
+
+	std::atomic_store(&statusSnapshot, StatusSnapshot_ptr(std::move(snapshot)));
+}
+
+void ProtocolStatus::sendStatusString(const StatusSnapshot_ptr& snapshot)
+{
+	auto output = OutputMessagePool::getOutputMessage();
+
+	setRawMessages(true);
+
+	std::string uptime = std::to_string((OTSYS_TIME() - ProtocolStatus::start) / 1000);
+	output->addBytes(snapshot->xmlHead.c_str(), snapshot->xmlHead.size());
+	output->addBytes(uptime.c_str(), uptime.size());
+	output->addBytes(snapshot->xmlTail.c_str(), snapshot->xmlTail.size());
 	send(output);
 	disconnect();
 }
 
-void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string& characterName)
+void ProtocolStatus::sendInfo(const StatusSnapshot_ptr& snapshot, uint16_t requestedInfo, const std::string& characterName)
 {
 	auto output = OutputMessagePool::getOutputMessage();
 
 	if (requestedInfo & REQUEST_BASIC_SERVER_INFO) {
 		output->addByte(0x10);
-		output->addString(g_config.getString(ConfigManager::SERVER_NAME));
-		output->addString(g_config.getString(ConfigManager::IP));
-		output->addString(std::to_string(g_config.getNumber(ConfigManager::LOGIN_PORT)));
+		output->addString(snapshot->serverName);
+		output->addString(snapshot->ip);
+		output->addString(snapshot->loginPort);
 	}
 
 	if (requestedInfo & REQUEST_OWNER_SERVER_INFO) {
 		output->addByte(0x11);
-		output->addString(g_config.getString(ConfigManager::OWNER_NAME));
-		output->addString(g_config.getString(ConfigManager::OWNER_EMAIL));
+		output->addString(snapshot->ownerName);
+		output->addString(snapshot->ownerEmail);
 	}
 
 	if (requestedInfo & REQUEST_MISC_SERVER_INFO) {
 		output->addByte(0x12);
-		output->addString(g_config.getString(ConfigManager::MOTD));
-		output->addString(g_config.getString(ConfigManager::LOCATION));
-		output->addString(g_config.getString(ConfigManager::URL));
+		output->addString(snapshot->motd);
+		output->addString(snapshot->location);
+		output->addString(snapshot->url);
 		output->add<uint64_t>((OTSYS_TIME() - ProtocolStatus::start) / 1000);
 	}
 
 	if (requestedInfo & REQUEST_PLAYERS_INFO) {
 		output->addByte(0x20);
-		output->add<uint32_t>(g_game.getPlayersOnline());
-		output->add<uint32_t>(g_config.getNumber(ConfigManager::MAX_PLAYERS));
-		output->add<uint32_t>(g_game.getPlayersRecord());
+		output->add<uint32_t>(snapshot->playersOnline);
+		output->add<uint32_t>(snapshot->maxPlayers);
+		output->add<uint32_t>(snapshot->playersRecord);
 	}
 
 	if (requestedInfo & REQUEST_MAP_INFO) {
 		output->addByte(0x30);
-		output->addString(g_config.getString(ConfigManager::MAP_NAME));
-		output->addString(g_config.getString(ConfigManager::MAP_AUTHOR));
-		uint32_t mapWidth, mapHeight;
-		g_game.getMapDimensions(mapWidth, mapHeight);
-		output->add<uint16_t>(mapWidth);
-		output->add<uint16_t>(mapHeight);
+		output->addString(snapshot->mapName);
+		output->addString(snapshot->mapAuthor);
+		output->add<uint16_t>(snapshot->mapWidth);
+		output->add<uint16_t>(snapshot->mapHeight);
 	}
 
 	if (requestedInfo & REQUEST_EXT_PLAYERS_INFO) {
 		output->addByte(0x21); // players info - online players list
 
-		const auto& players = g_game.getPlayers();
-		output->add<uint32_t>(players.size());
-		for (const auto& it : players) {
-			output->addString(it.second->getName());
-			output->add<uint32_t>(it.second->getLevel());
+		output->add<uint32_t>(snapshot->players.size());
+		for (const auto& it : snapshot->players) {
+			output->addString(it.first);
+			output->add<uint32_t>(it.second);
 		}
 	}
 
 	if (requestedInfo & REQUEST_PLAYER_STATUS_INFO) {
 		output->addByte(0x22); // players info - online status info of a player
-		if (g_game.getPlayerByName(characterName) != nullptr) {
+		if (snapshot->playerNames.find(asLowerCaseString(characterName)) != snapshot->playerNames.end()) {
 			output->addByte(0x01);
 		} else {
 			output->addByte(0x00);
@@ -223,7 +282,7 @@ void ProtocolStatus::sendInfo(uint16_t requestedInfo, const std::string& charact
 		output->addByte(0x23); // server software info
 		output->addString(STATUS_SERVER_NAME);
 		output->addString(STATUS_SERVER_VERSION);
-		output->addString(g_config.getString(ConfigManager::CLIENT_VERSION_STR));
+		output->addString(snapshot->clientVersion);
 	}
 	send(output);
 	disconnect();
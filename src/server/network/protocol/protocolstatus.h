@@ -23,6 +23,46 @@
 #include "server/network/message/networkmessage.h"
 #include "server/network/protocol/protocol.h"
 
+#include <unordered_set>
+
+/**
+ * Immutable copy of everything the status protocol answers with.
+ * Built on the dispatcher and read by the network thread, so requests
+ * never have to wait for the game loop.
+ */
+struct StatusSnapshot
+{
+	// XML status document split around the uptime value, which is filled in per request
+	std::string xmlHead;
+	std::string xmlTail;
+
+	std::string serverName;
+	std::string ip;
+	std::string loginPort;
+	std::string ownerName;
+	std::string ownerEmail;
+	std::string motd;
+	std::string location;
+	std::string url;
+	std::string mapName;
+	std::string mapAuthor;
+	std::string clientVersion;
+
+	uint32_t playersOnline = 0;
+	uint32_t maxPlayers = 0;
+	uint32_t playersRecord = 0;
+	uint16_t mapWidth = 0;
+	uint16_t mapHeight = 0;
+
+	std::vector<std::pair<std::string, uint32_t>> players;
+	// lower case names, for the player status request
+	std::unordered_set<std::string> playerNames;
+
+	int64_t createdAt = 0;
+};
+
+using StatusSnapshot_ptr = std::shared_ptr<const StatusSnapshot>;
+
 class ProtocolStatus final : public Protocol
 {
 	public:
@@ -38,13 +78,22 @@ class ProtocolStatus final : public Protocol
 
 		void onRecvFirstMessage(NetworkMessage& msg) override;
 
-		void sendStatusString();
-		void sendInfo(uint16_t requestedInfo, const std::string& characterName);
+		void sendStatusString(const StatusSnapshot_ptr& snapshot);
+		void sendInfo(const StatusSnapshot_ptr& snapshot, uint16_t requestedInfo, const std::string& characterName);
+
+		// dispatcher thread
+		static void updateStatusSnapshot();
+		static void checkStatusSnapshot();
 
 		static const uint64_t start;
 
 	private:
+		static StatusSnapshot_ptr getStatusSnapshot() {
+			return std::atomic_load(&statusSnapshot);
+		}
+
 		static std::map<uint32_t, int64_t> ipConnectMap;
+		static StatusSnapshot_ptr statusSnapshot;
 };
 
 #endif
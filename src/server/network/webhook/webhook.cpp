@@ -5,11 +5,16 @@
 #include <curl/curl.h>
 #include <json/json.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <iostream>
 #include <memory>
 
 #include "config/configmanager.h"
+#include "utils/thread_holder_base.h"
+#include "utils/tools.h"
 
 extern ConfigManager g_config;
 
@@ -19,6 +24,56 @@ extern ConfigManager g_config;
 static bool init = false;
 static curl_slist *headers = NULL;
 
+// Messages are delivered by a dedicated thread so a slow or unreachable
+// endpoint never holds up the caller (the dispatcher, most of the time).
+// Messages queued for the same url while the previous one is in flight are
+// merged into one request, Discord takes up to 10 embeds per message.
+static constexpr size_t WEBHOOK_QUEUE_SIZE = 128;
+static constexpr size_t WEBHOOK_MAX_EMBEDS = 10;
+static constexpr uint32_t WEBHOOK_MAX_ATTEMPTS = 5;
+static constexpr int64_t WEBHOOK_RETRY_DELAY = 1000;
+static constexpr long WEBHOOK_REQUEST_TIMEOUT = 10;
+// how long shutdown keeps delivering what is queued before dropping it
+static constexpr int64_t WEBHOOK_SHUTDOWN_TIMEOUT = 3000;
+
+struct WebhookMessage {
+	std::string url;
+	std::vector<Json::Value> embeds;
+	uint32_t attempts = 0;
+	int64_t nextAttempt = 0;
+};
+
+class WebhookWorker : public ThreadHolder<WebhookWorker> {
+	public:
+		bool start();
+		void shutdown();
+		void addMessage(std::string url, Json::Value embed);
+
+		void threadMain();
+
+	private:
+		// HTTP status of the request, -1 when it never got an answer
+		int sendMessage(const WebhookMessage& message, std::string& response_body);
+		bool flushExpired() const {
+			return getState() != THREAD_STATE_RUNNING && OTSYS_TIME() >= flushDeadline;
+		}
+
+		std::deque<WebhookMessage> messages;
+		std::mutex messageLock;
+		std::condition_variable messageSignal;
+		std::atomic<int64_t> flushDeadline{0};
+
+		// the multi handle keeps the connection cache, so the endpoint is
+		// reached over the same keep-alive connection between messages
+		CURLM *multi = nullptr;
+		CURL *curl = nullptr;
+};
+
+static WebhookWorker webhookWorker;
+
+static std::string get_payload(const std::vector<Json::Value>& embeds);
+static Json::Value get_embed(std::string title, std::string message, int color);
+
 void webhook_init() {
 	if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
 		SPDLOG_ERROR("Failed to init curl, no webhook messages may be sent");
@@ -32,14 +87,30 @@ void webhook_init() {
 		return;
 	}
 
+	if (!webhookWorker.start()) {
+		SPDLOG_ERROR("Failed to init curl, creating the transfer handles failed");
+		return;
+	}
+
 	init = true;
 }
 
-static int webhook_send_message_(const char *url, const char *payload, std::string *response_body);
-static std::string get_payload(std::string title, std::string message, int color);
+void webhook_shutdown() {
+	if (!init) {
+		return;
+	}
+
+	init = false;
+	webhookWorker.shutdown();
+	webhookWorker.join();
+}
 
 void webhook_send_message(std::string title, std::string message, int color) {
-	std::string url = g_config.getString(ConfigManager::DISCORD_WEBHOOK_URL);
+	webhook_send_specialmessage(std::move(title), std::move(message), color,
+                                g_config.getString(ConfigManager::DISCORD_WEBHOOK_URL));
+}
+
+void webhook_send_specialmessage(std::string title, std::string message, int color, std::string url) {
 	if (url.empty()) {
 		return;
 	}
@@ -55,47 +126,120 @@ void webhook_send_message(std::string title, std::string message, int color) {
 		return;
 	}
 
-	std::string payload = get_payload(title, message, color);
-	std::string response_body = "";
-	int response_code = webhook_send_message_(url.c_str(), payload.c_str(), &response_body);
+	// built now so the footer carries the time of the event, not of the delivery
+	webhookWorker.addMessage(std::move(url), get_embed(std::move(title), std::move(message), color));
+}
 
-	if (response_code != 204 && response_code != -1) {
-		SPDLOG_ERROR("Failed to send webhook message; "
-                     "HTTP request failed with code: {}"
-                     "response body: {} request body: {}",
-                     response_code, response_body, payload);
+bool WebhookWorker::start() {
+	multi = curl_multi_init();
+	curl = curl_easy_init();
+	if (!multi || !curl) {
+		return false;
 	}
+
+	ThreadHolder::start();
+	return true;
 }
 
-void webhook_send_specialmessage(std::string title, std::string message, int color, std::string url) {
-	if (url.empty()) {
+void WebhookWorker::shutdown() {
+	messageLock.lock();
+	flushDeadline = OTSYS_TIME() + WEBHOOK_SHUTDOWN_TIMEOUT;
+	setState(THREAD_STATE_CLOSING);
+	messageLock.unlock();
+	messageSignal.notify_one();
+}
+
+void WebhookWorker::addMessage(std::string url, Json::Value embed) {
+	std::lock_guard<std::mutex> lockGuard(messageLock);
+	if (getState() != THREAD_STATE_RUNNING) {
 		return;
 	}
 
-	if (!init) {
-		SPDLOG_ERROR("Failed to send webhook message; Did not (successfully) init");
-		return;
+	if (!messages.empty()) {
+		WebhookMessage& last = messages.back();
+		if (last.url == url && last.attempts == 0 && last.embeds.size() < WEBHOOK_MAX_EMBEDS) {
+			last.embeds.push_back(std::move(embed));
+			return;
+		}
 	}
 
-	if (title.empty() || message.empty()) {
-		SPDLOG_ERROR("Failed to send webhook message; "
-                     "title or message to send was empty");
+	if (messages.size() >= WEBHOOK_QUEUE_SIZE) {
+		SPDLOG_WARN("Webhook queue is full, dropping message: {}", embed["title"].asString());
 		return;
 	}
 
-	std::string payload = get_payload(title, message, color);
-	std::string response_body = "";
-	int response_code = webhook_send_message_(url.c_str(), payload.c_str(), &response_body);
+	messages.emplace_back();
+	messages.back().url = std::move(url);
+	messages.back().embeds.push_back(std::move(embed));
+	messageSignal.notify_one();
+}
+
+void WebhookWorker::threadMain() {
+	std::unique_lock<std::mutex> messageLockUnique(messageLock);
+	while (true) {
+		bool closing = getState() != THREAD_STATE_RUNNING;
+		if (closing && !messages.empty() && flushExpired()) {
+			SPDLOG_WARN("Webhook delivery timed out on shutdown, dropping {} queued messages", messages.size());
+			messages.clear();
+			break;
+		}
+
+		if (messages.empty()) {
+			if (closing) {
+				break;
+			}
+			messageSignal.wait(messageLockUnique);
+			continue;
+		}
+
+		// messages stay in order, a failed one holds back the ones after it
+		int64_t wait = messages.front().nextAttempt - OTSYS_TIME();
+		if (wait > 0 && !closing) {
+			messageSignal.wait_for(messageLockUnique, std::chrono::milliseconds(wait));
+			continue;
+		}
+
+		WebhookMessage message = std::move(messages.front());
+		messages.pop_front();
+		messageLockUnique.unlock();
+
+		std::string response_body;
+		int response_code = sendMessage(message, response_body);
+		bool retry = response_code == -1 || response_code == 429 || response_code >= 500;
+
+		messageLockUnique.lock();
+		if (response_code >= 200 && response_code < 300) {
+			continue;
+		}
+
+		// cut short by the shutdown deadline, dropped along with the rest of the queue
+		if (flushExpired()) {
+			messages.push_front(std::move(message));
+			continue;
+		}
+
+		// nothing is retried once the server is going down
+		if (retry && ++message.attempts < WEBHOOK_MAX_ATTEMPTS && getState() == THREAD_STATE_RUNNING) {
+			message.nextAttempt = OTSYS_TIME() + (WEBHOOK_RETRY_DELAY << (message.attempts - 1));
+			messages.push_front(std::move(message));
+			continue;
+		}
 
-	if (response_code != 204 && response_code != -1) {
 		SPDLOG_ERROR("Failed to send webhook message; "
-                     "HTTP request failed with code: {}"
+                     "HTTP request failed with code: {} "
                      "response body: {} request body: {}",
-                     response_code, response_body, payload);
+                     response_code, response_body, get_payload(message.embeds));
 	}
+	messageLockUnique.unlock();
+
+	setState(THREAD_STATE_TERMINATED);
+	curl_easy_cleanup(curl);
+	curl_multi_cleanup(multi);
+	curl = nullptr;
+	multi = nullptr;
 }
 
-static std::string get_payload(std::string title, std::string message, int color) {
+static Json::Value get_embed(std::string title, std::string message, int color) {
 	time_t now;
 	time(&now);
 	struct tm tm;
@@ -125,12 +269,17 @@ static std::string get_payload(std::string title, std::string message, int color
 	if (color >= 0) {
 		embed["color"] = color;
 	}
+	return embed;
+}
 
-	Json::Value embeds(Json::arrayValue);
-	embeds.append(embed);
+static std::string get_payload(const std::vector<Json::Value>& embeds) {
+	Json::Value embedArray(Json::arrayValue);
+	for (const Json::Value& embed : embeds) {
+		embedArray.append(embed);
+	}
 
 	Json::Value payload(Json::objectValue);
-	payload["embeds"] = embeds;
+	payload["embeds"] = embedArray;
 
 	Json::StreamWriterBuilder builder;
 	builder["commentSyle"] = "None";
@@ -148,34 +297,54 @@ static size_t write_data(void *ptr, size_t size, size_t nmemb, void *userdata) {
 	return size * nmemb;
 }
 
-static int webhook_send_message_(const char *url, const char *payload, std::string *response_body) {
-	CURL *curl = curl_easy_init();
-	if (!curl) {
-		SPDLOG_ERROR("Failed to send webhook message; curl_easy_init failed");
-		return -1;
-	}
+int WebhookWorker::sendMessage(const WebhookMessage& message, std::string& response_body) {
+	std::string payload = get_payload(message.embeds);
 
-	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_URL, message.url.c_str());
 	curl_easy_setopt(curl, CURLOPT_POST, 1L);
-	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload);
+	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
+	curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(payload.size()));
 
 	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &write_data);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, reinterpret_cast<void *>(&response_body));
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, static_cast<void *>(&response_body));
 
 	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
 	curl_easy_setopt(curl, CURLOPT_USERAGENT, "otservbr-global (https://github.com/Hydractify/otservbr-global)");
+	curl_easy_setopt(curl, CURLOPT_TIMEOUT, WEBHOOK_REQUEST_TIMEOUT);
+	curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+	curl_multi_add_handle(multi, curl);
+
+	int running = 1;
+	while (running) {
+		if (curl_multi_perform(multi, &running) != CURLM_OK) {
+			break;
+		}
+
+		if (running) {
+			curl_multi_wait(multi, nullptr, 0, 100, nullptr);
+			if (flushExpired()) {
+				curl_multi_remove_handle(multi, curl);
+				return -1;
+			}
+		}
+	}
 
-	CURLcode res = curl_easy_perform(curl);
+	CURLcode res = CURLE_FAILED_INIT;
+	int pending;
+	while (CURLMsg *msg = curl_multi_info_read(multi, &pending)) {
+		if (msg->msg == CURLMSG_DONE && msg->easy_handle == curl) {
+			res = msg->data.result;
+		}
+	}
+	curl_multi_remove_handle(multi, curl);
 
-	int response_code = -1;
+	long response_code = -1;
 	if (res == CURLE_OK) {
 		curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
 	} else {
-		SPDLOG_ERROR("Failed to send webhook message with the error: {}",
-                     curl_easy_strerror(res));
+		SPDLOG_WARN("Failed to send webhook message with the error: {}",
+                    curl_easy_strerror(res));
 	}
-
-	curl_easy_cleanup(curl);
-
-	return response_code;
+	return static_cast<int>(response_code);
 }
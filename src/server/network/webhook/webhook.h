@@ -5,6 +5,9 @@
 
 void webhook_init();
 
+// Sends what is still queued, without retrying failures, and stops the delivery thread
+void webhook_shutdown();
+
 void webhook_send_message(std::string title, std::string message, int color);
 
 void webhook_send_specialmessage(std::string title, std::string message, int color, std::string url);
@@ -32,6 +32,7 @@
 #include "lua/global/globalevent.h"
 #include "creatures/monsters/monster.h"
 #include "lua/creature/events.h"
+#include "lua/scripts/luaprofiler.h"
 #include "game/scheduling/scheduler.h"
 #include "database/databasetasks.h"
 
@@ -60,6 +61,7 @@ Signals::Signals(boost::asio::io_service& service) :
 	set.add(SIGTERM);
 #ifndef _WIN32
 	set.add(SIGUSR1);
+	set.add(SIGUSR2);
 	set.add(SIGHUP);
 #else
 	// This must be a blocking call as Windows calls it in a new thread and terminates
@@ -103,6 +105,9 @@ void Signals::dispatchSignalHandler(int signal)
 		case SIGUSR1: //Saves game state
 			g_dispatcher.addTask(createTask(sigusr1Handler));
 			break;
+		case SIGUSR2: //Starts or stops the Lua profiler
+			g_dispatcher.addTask(createTask(sigusr2Handler));
+			break;
 #else
 		case SIGBREAK: //Shuts the server down
 			g_dispatcher.addTask(createTask(sigbreakHandler));
@@ -139,6 +144,19 @@ void Signals::sigusr1Handler()
 	g_game.saveGameState();
 }
 
+void Signals::sigusr2Handler()
+{
+	//Dispatcher thread
+	LuaProfiler& profiler = LuaProfiler::getInstance();
+	if (profiler.isRunning()) {
+		SPDLOG_INFO("SIGUSR2 received, stopping the Lua profiler...");
+		profiler.stop(g_luaEnvironment.getLuaState());
+	} else {
+		SPDLOG_INFO("SIGUSR2 received, starting the Lua profiler...");
+		profiler.start(g_luaEnvironment.getLuaState());
+	}
+}
+
 void Signals::sighupHandler()
 {
 	//Dispatcher thread
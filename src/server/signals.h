@@ -37,6 +37,7 @@ class Signals
 		static void sighupHandler();
 		static void sigtermHandler();
 		static void sigusr1Handler();
+		static void sigusr2Handler();
 };
 
 #endif
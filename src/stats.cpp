@@ -18,6 +18,8 @@ void Stats::threadMain() {
         dispatcher.lastDump = OTSYS_TIME();
     }
     while(true) {
+        pollMetricsEndpoint();
+
         taskLockUnique.lock();
         std::vector<std::forward_list < Task * >> tasks;
         for (auto &dispatcher : dispatchers) {
@@ -28,8 +30,14 @@ void Stats::threadMain() {
         lua.queue.clear();
         std::forward_list < Stat * > sql_stats(std::move(sql.queue));
         sql.queue.clear();
+        std::forward_list<std::string> traces(std::move(slowTraces));
+        slowTraces.clear();
         taskLockUnique.unlock();
 
+        for (const std::string& trace : traces) {
+            writeTrace(trace);
+        }
+
         parseDispatchersQueue(tasks);
         parseLuaQueue(lua_stats);
         parseSqlQueue(sql_stats);
@@ -63,8 +71,14 @@ void Stats::threadMain() {
             sql.lastDump = OTSYS_TIME();
         }
 
-        if(last_iteration)
+        if(last_iteration) {
+            if (metricsAcceptor) {
+                boost::system::error_code error;
+                metricsAcceptor->close(error);
+                metricsService.poll();
+            }
             break;
+        }
         if(getState() == THREAD_STATE_TERMINATED) {
             last_iteration = true;
             continue;
@@ -88,6 +102,11 @@ void Stats::addSqlStats(Stat* stats) {
     sql.queue.push_front(stats);
 }
 
+void Stats::addSlowTrace(std::string&& trace) {
+    std::lock_guard<std::mutex> lockClass(statsLock);
+    slowTraces.push_front(std::move(trace));
+}
+
 void Stats::parseDispatchersQueue(std::vector<std::forward_list < Task * >> queues) {
     int i = 0;
     for(auto& dispatcher : dispatchers) {
@@ -146,6 +165,18 @@ void Stats::writeSlowInfo(const std::string& file, uint64_t executionTime, const
     out.close();
 }
 
+void Stats::writeTrace(const std::string& trace) {
+    static uint32_t traceCount = 0;
+    std::string file = std::string("stats/slow_task_") + std::to_string(OTSYS_TIME()) + "_" + std::to_string(++traceCount) + ".json";
+    std::ofstream out(file, std::ofstream::out | std::ofstream::trunc);
+    if (!out.is_open()) {
+        std::clog << "Can't open " << file << " (check if directory exists)" << std::endl;
+        return;
+    }
+    out << trace;
+    out.close();
+}
+
 void Stats::writeStats(const std::string& file, const statsMap& stats, const std::string& extraInfo) {
 	if(stats.empty()) {
 		return;
@@ -182,4 +213,310 @@ void Stats::writeStats(const std::string& file, const statsMap& stats, const std
     out << "\n";
     out.flush();
     out.close();
-}
\ No newline at end of file
+}
+
+void Stats::pollMetricsEndpoint() {
+    if (!metricsAcceptor && metricsPort != 0) {
+        try {
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), metricsPort);
+            metricsAcceptor.reset(new boost::asio::ip::tcp::acceptor(metricsService, endpoint));
+            SPDLOG_INFO("Metrics endpoint listening on 127.0.0.1:{}", metricsPort);
+            acceptMetricsClient();
+        } catch (boost::system::system_error& e) {
+            SPDLOG_ERROR("[Stats::pollMetricsEndpoint] - Can't bind metrics port {}: {}", metricsPort, e.what());
+            metricsPort = 0;
+            metricsAcceptor.reset();
+        }
+    }
+
+    if (metricsAcceptor) {
+        metricsService.poll();
+        metricsService.restart();
+    }
+}
+
+void Stats::acceptMetricsClient() {
+    auto socket = std::make_shared<boost::asio::ip::tcp::socket>(metricsService);
+    metricsAcceptor->async_accept(*socket, [this, socket](const boost::system::error_code& error) {
+        if (error == boost::asio::error::operation_aborted) {
+            return;
+        }
+
+        if (!error) {
+            // the request itself is ignored, any path gets the metrics
+            auto request = std::make_shared<boost::asio::streambuf>(4096);
+            boost::asio::async_read_until(*socket, *request, "\r\n\r\n", [socket, request](const boost::system::error_code& readError, size_t) {
+                if (readError) {
+                    return;
+                }
+
+                std::string body = g_metrics.scrape();
+                auto response = std::make_shared<std::string>();
+                response->reserve(body.size() + 128);
+                response->append("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\nContent-Length: ");
+                response->append(std::to_string(body.size()));
+                response->append("\r\n\r\n");
+                response->append(body);
+                boost::asio::async_write(*socket, boost::asio::buffer(*response), [socket, response](const boost::system::error_code&, size_t) {
+                    boost::system::error_code ignored;
+                    socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+                });
+            });
+        }
+
+        acceptMetricsClient();
+    });
+}
+
+size_t MetricsHistogram::getBucket(uint64_t ns) {
+    uint64_t us = ns / 1000;
+    if (us == 0) {
+        return 0;
+    }
+
+    size_t octave = 0;
+    while ((us >> (octave + 1)) != 0) {
+        ++octave;
+    }
+
+    size_t half = octave == 0 ? 0 : (us >> (octave - 1)) & 1;
+    return std::min<size_t>(1 + octave * 2 + half, BUCKETS - 1);
+}
+
+uint64_t MetricsHistogram::getBucketBound(size_t bucket) {
+    if (bucket == 0) {
+        return 1;
+    }
+
+    size_t octave = (bucket - 1) / 2;
+    if (octave == 0) {
+        return 2;
+    }
+    return (UINT64_C(1) << octave) + (((bucket - 1) % 2) + 1) * (UINT64_C(1) << (octave - 1));
+}
+
+void MetricsHistogram::record(uint64_t ns) {
+    auto& bucket = buckets[getBucket(ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+Metrics::Shard& Metrics::getShard() {
+    thread_local Shard* shard = nullptr;
+    if (!shard) {
+        std::lock_guard<std::mutex> lockClass(metricsLock);
+        shards.emplace_back(new Shard());
+        shard = shards.back().get();
+    }
+    return *shard;
+}
+
+uint16_t Metrics::internTask(const std::string& description) {
+    thread_local std::unordered_map<std::string, uint16_t> cache;
+    auto it = cache.find(description);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    uint16_t id;
+    {
+        std::lock_guard<std::mutex> lockClass(metricsLock);
+        auto taskIt = taskIds.find(description);
+        if (taskIt != taskIds.end()) {
+            id = taskIt->second;
+        } else if (taskNames.size() + 1 < MAX_TASKS) {
+            id = static_cast<uint16_t>(taskNames.size());
+            taskNames.push_back(description.substr(0, 100));
+            taskIds.emplace(description, id);
+        } else {
+            // everything past the limit shares the last slot
+            id = MAX_TASKS - 1;
+        }
+    }
+    cache.emplace(description, id);
+    return id;
+}
+
+void Metrics::add(MetricCounter_t counter, uint64_t value/* = 1*/) {
+    auto& total = getShard().counters[counter];
+    total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void Metrics::record(MetricHistogram_t histogram, uint64_t ns) {
+    getShard().histograms[histogram].record(ns);
+}
+
+void Metrics::recordTask(const std::string& description, uint64_t ns) {
+    // tasks only carry a description in STATS_ENABLED builds, without one
+    // they would all share a single series
+    if (description.empty()) {
+        return;
+    }
+
+    uint16_t id = internTask(description);
+    auto& slot = getShard().tasks[id];
+    MetricsHistogram* histogram = slot.load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new MetricsHistogram();
+        slot.store(histogram, std::memory_order_release);
+    }
+    histogram->record(ns);
+}
+
+namespace {
+
+void writeLabel(std::ostringstream& out, const std::string& name, const std::string& value) {
+    out << name << "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out << '\\' << c;
+        } else if (c == '\n') {
+            out << "\\n";
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void writeHistogram(std::ostringstream& out, const std::string& name, const std::string& labels, const std::array<uint64_t, MetricsHistogram::BUCKETS>& buckets, uint64_t sum) {
+    std::string separator = labels.empty() ? "" : ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < MetricsHistogram::BUCKETS - 1; ++i) {
+        // empty buckets are skipped to keep per task series short
+        if (buckets[i] == 0) {
+            continue;
+        }
+        cumulative += buckets[i];
+        out << name << "_bucket{" << labels << separator << "le=\"" << MetricsHistogram::getBucketBound(i) / 1e6 << "\"} " << cumulative << '\n';
+    }
+    cumulative += buckets.back();
+    out << name << "_bucket{" << labels << separator << "le=\"+Inf\"} " << cumulative << '\n';
+    if (labels.empty()) {
+        out << name << "_sum " << sum / 1e9 << '\n';
+        out << name << "_count " << cumulative << '\n';
+    } else {
+        out << name << "_sum{" << labels << "} " << sum / 1e9 << '\n';
+        out << name << "_count{" << labels << "} " << cumulative << '\n';
+    }
+}
+
+void mergeHistogram(const MetricsHistogram& histogram, std::array<uint64_t, MetricsHistogram::BUCKETS>& buckets, uint64_t& sum) {
+    for (size_t i = 0; i < MetricsHistogram::BUCKETS; ++i) {
+        buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+    }
+    sum += histogram.sum.load(std::memory_order_relaxed);
+}
+
+}
+
+std::string Metrics::scrape() {
+    static const char* counterNames[METRIC_COUNTER_LAST] = {
+        "otserv_packets_received_total",
+        "otserv_packets_sent_total",
+        "otserv_network_received_bytes_total",
+        "otserv_network_sent_bytes_total",
+        "otserv_spectator_cache_hits_total",
+    };
+    static const char* histogramNames[METRIC_HISTOGRAM_LAST] = {
+        "otserv_dispatcher_tick_seconds",
+        "otserv_spectator_query_seconds",
+        "otserv_sql_query_seconds",
+    };
+
+    std::lock_guard<std::mutex> lockClass(metricsLock);
+
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    for (size_t i = 0; i < METRIC_COUNTER_LAST; ++i) {
+        uint64_t total = 0;
+        for (const auto& shard : shards) {
+            total += shard->counters[i].load(std::memory_order_relaxed);
+        }
+        out << "# TYPE " << counterNames[i] << " counter\n" << counterNames[i] << ' ' << total << '\n';
+    }
+
+    out << "# TYPE otserv_dispatcher_queue_tasks gauge\n";
+    for (size_t i = 0; i < dispatcherQueue.size(); ++i) {
+        out << "otserv_dispatcher_queue_tasks{dispatcher=\"" << i << "\"} " << dispatcherQueue[i].load(std::memory_order_relaxed) << '\n';
+    }
+
+    out << "# TYPE otserv_players_online gauge\notserv_players_online " << g_stats.playersOnline << '\n';
+
+    for (size_t i = 0; i < METRIC_HISTOGRAM_LAST; ++i) {
+        std::array<uint64_t, MetricsHistogram::BUCKETS> buckets{};
+        uint64_t sum = 0;
+        for (const auto& shard : shards) {
+            mergeHistogram(shard->histograms[i], buckets, sum);
+        }
+        out << "# TYPE " << histogramNames[i] << " histogram\n";
+        writeHistogram(out, histogramNames[i], "", buckets, sum);
+    }
+
+    out << "# HELP otserv_task_seconds Dispatcher task run time by task, only recorded when built with STATS_ENABLED\n";
+    out << "# TYPE otserv_task_seconds histogram\n";
+    for (size_t id = 0; id < MAX_TASKS; ++id) {
+        std::array<uint64_t, MetricsHistogram::BUCKETS> buckets{};
+        uint64_t sum = 0;
+        bool found = false;
+        for (const auto& shard : shards) {
+            if (const MetricsHistogram* histogram = shard->tasks[id].load(std::memory_order_acquire)) {
+                mergeHistogram(*histogram, buckets, sum);
+                found = true;
+            }
+        }
+
+        if (found) {
+            std::ostringstream labels;
+            writeLabel(labels, "task", id < taskNames.size() ? taskNames[id] : "other");
+            writeHistogram(out, "otserv_task_seconds", labels.str(), buckets, sum);
+        }
+    }
+    return out.str();
+}
+
+std::string Tracer::dump(size_t mark) const {
+    size_t first = mark;
+    bool truncated = false;
+    if (head - first > RING_SIZE) {
+        first = head - RING_SIZE;
+        truncated = true;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[";
+    uint64_t origin = ring[first & (RING_SIZE - 1)].begin;
+    bool separator = false;
+    for (size_t i = first; i != head; ++i) {
+        const TraceEvent& event = ring[i & (RING_SIZE - 1)];
+        if (event.end == 0) {
+            continue;
+        }
+
+        if (separator) {
+            out << ',';
+        }
+        separator = true;
+
+        out << "{\"name\":\"";
+        for (const char* c = event.name; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\' << *c;
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                out << ' ';
+            } else {
+                out << *c;
+            }
+        }
+        out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << (event.begin - origin) / 1000. << ",\"dur\":" << (event.end - event.begin) / 1000.;
+        if (event.arg != 0) {
+            out << ",\"args\":{\"id\":" << event.arg << '}';
+        }
+        out << '}';
+    }
+    out << "],\"otherData\":{\"truncated\":" << (truncated ? "true" : "false") << "}}";
+    return out.str();
+}
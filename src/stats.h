@@ -3,6 +3,7 @@
 
 #include "utils/thread_holder_base.h"
 
+#include <array>
 #include <forward_list>
 #include <atomic>
 
@@ -38,6 +39,149 @@ struct statsData {
 
 using statsMap = std::map<std::string, statsData>;
 
+enum MetricCounter_t : uint8_t {
+	METRIC_PACKETS_IN,
+	METRIC_PACKETS_OUT,
+	METRIC_BYTES_IN,
+	METRIC_BYTES_OUT,
+	METRIC_SPECTATOR_CACHE_HITS,
+
+	METRIC_COUNTER_LAST
+};
+
+enum MetricHistogram_t : uint8_t {
+	METRIC_DISPATCHER_TICK,
+	METRIC_SPECTATOR_QUERY,
+	METRIC_SQL_QUERY,
+
+	METRIC_HISTOGRAM_LAST
+};
+
+// Latency histogram with two buckets per power of two microseconds, written
+// by a single thread and read by the scrape endpoint.
+struct MetricsHistogram {
+	static constexpr size_t BUCKETS = 48;
+
+	void record(uint64_t ns);
+	static size_t getBucket(uint64_t ns);
+	// upper bound in microseconds, the last bucket has none
+	static uint64_t getBucketBound(size_t bucket);
+
+	std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+	std::atomic<uint64_t> sum{0};
+	std::atomic<uint64_t> count{0};
+};
+
+class Metrics {
+	public:
+		void add(MetricCounter_t counter, uint64_t value = 1);
+		void record(MetricHistogram_t histogram, uint64_t ns);
+		// per task series need the task descriptions of STATS_ENABLED builds
+		void recordTask(const std::string& description, uint64_t ns);
+		void setDispatcherQueue(int index, size_t size) {
+			dispatcherQueue[index].store(size, std::memory_order_relaxed);
+		}
+
+		// Prometheus text exposition of everything recorded so far
+		std::string scrape();
+
+	private:
+		static constexpr size_t MAX_TASKS = 1024;
+
+		// counters of one thread, only that thread writes to them so updates
+		// are plain relaxed stores instead of locked read-modify-writes
+		struct Shard {
+			~Shard() {
+				for (auto& task : tasks) {
+					delete task.load(std::memory_order_relaxed);
+				}
+			}
+
+			std::array<std::atomic<uint64_t>, METRIC_COUNTER_LAST> counters{};
+			std::array<MetricsHistogram, METRIC_HISTOGRAM_LAST> histograms;
+			// indexed by interned task description, allocated on first use
+			std::array<std::atomic<MetricsHistogram*>, MAX_TASKS> tasks{};
+		};
+
+		Shard& getShard();
+		uint16_t internTask(const std::string& description);
+
+		std::mutex metricsLock;
+		std::vector<std::unique_ptr<Shard>> shards;
+		std::vector<std::string> taskNames;
+		std::unordered_map<std::string, uint16_t> taskIds;
+		std::array<std::atomic<uint64_t>, 3> dispatcherQueue{};
+};
+
+extern Metrics g_metrics;
+
+struct TraceEvent {
+	const char* name;
+	uint64_t begin;
+	uint64_t end;
+	uint32_t arg;
+};
+
+// Ring buffer of the spans recorded by one thread. Spans are only read back
+// when a dispatcher task turned out to be slow, so recording one is two clock
+// reads and a few stores.
+class Tracer {
+	public:
+		static Tracer& getInstance() {
+			thread_local Tracer tracer;
+			return tracer;
+		}
+
+		size_t begin(const char* name, uint32_t arg) {
+			size_t index = head++;
+			TraceEvent& event = ring[index & (RING_SIZE - 1)];
+			event.name = name;
+			event.arg = arg;
+			event.begin = now();
+			event.end = 0;
+			return index;
+		}
+
+		void end(size_t index) {
+			if (head - index <= RING_SIZE) {
+				ring[index & (RING_SIZE - 1)].end = now();
+			}
+		}
+
+		size_t getHead() const {
+			return head;
+		}
+
+		// Chrome trace event JSON of the spans started since mark
+		std::string dump(size_t mark) const;
+
+	private:
+		static constexpr size_t RING_SIZE = 8192;
+
+		static uint64_t now() {
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		std::array<TraceEvent, RING_SIZE> ring;
+		size_t head = 0;
+};
+
+class TraceSpan {
+	public:
+		explicit TraceSpan(const char* name, uint32_t arg = 0) : tracer(Tracer::getInstance()), index(tracer.begin(name, arg)) {}
+		~TraceSpan() {
+			tracer.end(index);
+		}
+
+		// non-copyable
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+	private:
+		Tracer& tracer;
+		size_t index;
+};
+
 class Stats : public ThreadHolder<Stats> {
 	public:
 		void threadMain();
@@ -48,6 +192,7 @@ class Stats : public ThreadHolder<Stats> {
 		void addDispatcherTask(int index, Task* task);
 		void addLuaStats(Stat* stats);
 		void addSqlStats(Stat* stats);
+		void addSlowTrace(std::string&& trace);
 		std::atomic<uint64_t>& dispatcherWaitTime(int index) {
 			return dispatchers[index].waitTime;
 		}
@@ -58,12 +203,20 @@ class Stats : public ThreadHolder<Stats> {
 
 		std::atomic<uint32_t> playersOnline;
 
+		// serves g_metrics on 127.0.0.1:port from the stats thread, 0 disables it
+		void setMetricsPort(uint16_t port) {
+			metricsPort = port;
+		}
+
 	private:
 		void parseDispatchersQueue(std::vector<std::forward_list < Task * >> queues);
 		void parseLuaQueue(std::forward_list <Stat*>& queue);
 		void parseSqlQueue(std::forward_list <Stat*>& queue);
 		void writeSlowInfo(const std::string& file, uint64_t executionTime, const std::string& description, const std::string& extraDescription);
 		void writeStats(const std::string& file, const statsMap& stats, const std::string& extraInfo = "");
+		void writeTrace(const std::string& trace);
+		void pollMetricsEndpoint();
+		void acceptMetricsClient();
 
 		std::mutex statsLock;
 		struct {
@@ -77,6 +230,11 @@ class Stats : public ThreadHolder<Stats> {
 			statsMap stats;
 			int64_t lastDump;
 		} lua, sql;
+		std::forward_list<std::string> slowTraces;
+
+		std::atomic<uint16_t> metricsPort{0};
+		boost::asio::io_service metricsService;
+		std::unique_ptr<boost::asio::ip::tcp::acceptor> metricsAcceptor;
 };
 
 extern Stats g_stats;
@@ -303,33 +303,89 @@ IntegerVector vectorAtoi(const StringVector& stringVector)
 	return returnVector;
 }
 
-std::mt19937& getRandomGenerator()
+void RandomGenerator::seed(uint64_t seedValue)
 {
-	static std::random_device rd;
-	static std::mt19937 generator(rd());
+	// splitmix64 expands the seed so that similar seeds give unrelated states
+	for (uint64_t& word : state) {
+		uint64_t z = (seedValue += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		word = z ^ (z >> 31);
+	}
+}
+
+RandomGenerator& getRandomGenerator()
+{
+	thread_local RandomGenerator generator([]() {
+		std::random_device rd;
+		return (static_cast<uint64_t>(rd()) << 32) | rd();
+	}());
 	return generator;
 }
 
+static uint64_t multiplyHigh(uint64_t a, uint64_t b, uint64_t& low)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	low = static_cast<uint64_t>(product);
+	return static_cast<uint64_t>(product >> 64);
+#else
+	uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+	uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+	uint64_t lowLow = aLow * bLow;
+	uint64_t highLow = aHigh * bLow;
+	uint64_t lowHigh = aLow * bHigh;
+	uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+	low = (cross << 32) | (lowLow & 0xFFFFFFFF);
+	return aHigh * bHigh + (highLow >> 32) + (cross >> 32);
+#endif
+}
+
+// unbiased number in [0, range), the division only runs on the rare rejection path (Lemire)
+static uint64_t bounded_random(uint64_t range)
+{
+	RandomGenerator& generator = getRandomGenerator();
+	uint64_t low;
+	uint64_t high = multiplyHigh(generator(), range, low);
+	if (low < range) {
+		const uint64_t threshold = (0 - range) % range;
+		while (low < threshold) {
+			high = multiplyHigh(generator(), range, low);
+		}
+	}
+	return high;
+}
+
 int64_t uniform_random(int64_t minNumber, int64_t maxNumber)
 {
-	static std::uniform_int_distribution<int64_t> uniformRand;
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
 		std::swap(minNumber, maxNumber);
 	}
-	return uniformRand(getRandomGenerator(), std::uniform_int_distribution<int64_t>::param_type(minNumber, maxNumber));
+
+	const uint64_t range = static_cast<uint64_t>(maxNumber) - static_cast<uint64_t>(minNumber) + 1;
+	if (range == 0) {
+		// the whole int64_t domain
+		return static_cast<int64_t>(getRandomGenerator()());
+	}
+	return static_cast<int64_t>(static_cast<uint64_t>(minNumber) + bounded_random(range));
+}
+
+static double unit_random()
+{
+	// the top 53 bits fill the double mantissa, result is in [0, 1)
+	return (getRandomGenerator()() >> 11) * 0x1.0p-53;
 }
 
 double uniform_double_random()
 {
-	static std::uniform_real_distribution<double> uniformRand(0.00, 100.00);
-	return uniformRand(getRandomGenerator());
+	return unit_random() * 100.00;
 }
 
 int64_t normal_random(int64_t minNumber, int64_t maxNumber)
 {
-	static std::normal_distribution<float> normalRand(0.5f, 0.25f);
+	thread_local std::normal_distribution<float> normalRand(0.5f, 0.25f);
 	if (minNumber == maxNumber) {
 		return minNumber;
 	} else if (minNumber > maxNumber) {
@@ -351,8 +407,7 @@ int64_t normal_random(int64_t minNumber, int64_t maxNumber)
 
 bool boolean_random(double probability/* = 0.5*/)
 {
-	static std::bernoulli_distribution booleanRand;
-	return booleanRand(getRandomGenerator(), std::bernoulli_distribution::param_type(probability));
+	return unit_random() < probability;
 }
 
 void trimString(std::string& str)
@@ -20,6 +20,7 @@
 #ifndef FS_TOOLS_H_5F9A9742DA194628830AA1C64909AE43
 #define FS_TOOLS_H_5F9A9742DA194628830AA1C64909AE43
 
+#include <limits>
 #include <random>
 #include <string>
 #include <regex>
@@ -52,7 +53,46 @@ constexpr bool hasBitSet(uint32_t flag, uint32_t flags) {
 	return (flags & flag) != 0;
 }
 
-std::mt19937& getRandomGenerator();
+// xoshiro256** by Blackman and Vigna, every thread owns its own instance
+class RandomGenerator
+{
+	public:
+		using result_type = uint64_t;
+
+		explicit RandomGenerator(uint64_t seedValue) {
+			seed(seedValue);
+		}
+
+		void seed(uint64_t seedValue);
+
+		static constexpr result_type min() {
+			return 0;
+		}
+		static constexpr result_type max() {
+			return std::numeric_limits<result_type>::max();
+		}
+
+		result_type operator()() {
+			const uint64_t result = rotl(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = rotl(state[3], 45);
+			return result;
+		}
+
+	private:
+		static constexpr uint64_t rotl(uint64_t x, int k) {
+			return (x << k) | (x >> (64 - k));
+		}
+
+		uint64_t state[4];
+};
+
+RandomGenerator& getRandomGenerator();
 int64_t uniform_random(int64_t minNumber, int64_t maxNumber);
 double uniform_double_random();
 int64_t normal_random(int64_t minNumber, int64_t maxNumber);